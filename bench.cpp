@@ -0,0 +1,354 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+#include "instance.hpp"
+#include "karger.hpp"
+#include "routes.hpp"
+#include "trimatrix.hpp"
+#include "unionfind.hpp"
+#include "cxxopts/cxxopts.hpp"
+
+#ifndef REVISION
+#define REVISION "unknown"
+#endif
+
+// Microbenchmarks of the parts of the solver that don't need Gurobi. Each benchmark runs its body until
+// min_time has passed, and writes a CSV row with the time per operation.
+
+struct BenchSettings
+{
+    double min_time;
+    std::string filter;
+    FILE* output;
+};
+
+// Results feed it so that the compiler can't drop the work
+volatile double sink = 0.0;
+
+// Instance with uniform points in a 1000 x 1000 grid and demands in [1, 10]
+struct BenchInstance
+{
+    int N;
+    double C;
+    std::vector<Point> points;
+    std::vector<double> demands;
+    TriMatrix<double> factors;
+};
+
+BenchInstance makeInstance(int N, unsigned int seed);
+Routes randomSolution(const BenchInstance& instance, std::mt19937& generator);
+TriMatrix<double> supportGraph(const BenchInstance& instance, int solutions, unsigned int seed);
+
+template <typename Body>
+void bench(const BenchSettings& settings, const std::string& name, int size, const std::string& variant, double ops_per_run, Body body)
+{
+    std::string id = name + "/" + std::to_string(size) + "/" + variant;
+    if (!settings.filter.empty() && id.find(settings.filter) == std::string::npos)
+        return;
+
+    std::vector<double> times;
+    double total = 0.0;
+    while (total < settings.min_time || times.size() < 3)
+    {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        times.push_back(elapsed);
+        total += elapsed;
+    }
+
+    std::sort(times.begin(), times.end());
+    double median = times[times.size() / 2];
+    double mean = total / times.size();
+    fprintf(settings.output, "%s,%s,%d,%s,%zu,%.0lf,%.3lf,%.3lf,%.3lf\n", REVISION, name.c_str(), size, variant.c_str(), times.size(), ops_per_run,
+        1e9 * mean / ops_per_run, 1e9 * median / ops_per_run, 1e9 * times[0] / ops_per_run);
+    fflush(settings.output);
+    printf("%-40s %12.1lf ns/op (median)\n", id.c_str(), 1e9 * median / ops_per_run);
+}
+
+void benchUnionFind(const BenchSettings& settings)
+{
+    for (int n : { 1000, 100000, 1000000 })
+    {
+        std::mt19937 generator(n);
+        std::vector<std::pair<unsigned int, unsigned int>> pairs(n);
+        for (auto& p : pairs)
+            p = { (unsigned int) (generator() % n), (unsigned int) (generator() % n) };
+
+        // unite does two finds, so this is the mix seen when Karger contracts edges
+        bench(settings, "unionfind", n, "unite", n, [&]() {
+            UnionFind sets(n);
+            for (auto& p : pairs)
+                sets.unite(p.first, p.second);
+            sink = sink + sets.find(0);
+        });
+
+        bench(settings, "unionfind", n, "find", n, [&]() {
+            UnionFind sets(n);
+            for (int i = 0; i + 1 < n; i += 2)
+                sets.unite(pairs[i].first, pairs[i].second);
+            unsigned int sum = 0;
+            for (auto& p : pairs)
+                sum += sets.find(p.first);
+            sink = sink + sum;
+        });
+    }
+}
+
+// Support graphs of the linear relaxation at a MIPNODE, averaged from a few solutions: with 2 most clients have
+// degree 2 to 4 like near the root, with 8 the graph is as dense as in a fractional early relaxation
+void benchKarger(const BenchSettings& settings)
+{
+    for (int N : { 100, 400, 1000 })
+        for (int solutions : { 2, 8 })
+        {
+            BenchInstance instance = makeInstance(N, N);
+            TriMatrix<double> support = supportGraph(instance, solutions, N + solutions);
+            double total_demand = std::accumulate(instance.demands.begin(), instance.demands.end(), 0.0);
+            int K = std::ceil(total_demand / instance.C);
+            std::string variant = "support" + std::to_string(solutions);
+
+            karger::EdgeVector cut_generator(N, 1);
+            bench(settings, "karger_setup", N, variant, 1, [&]() {
+                cut_generator.clear_edges();
+                for (int i = 1; i < N; i++)
+                    for (int j = 1; j < i; j++)
+                        cut_generator.add_edge(i, j, support(i, j));
+            });
+
+            std::vector<double> sum_of_demands;
+            bench(settings, "karger_randomcut", N, variant, 1, [&]() {
+                sum_of_demands.clear();
+                auto cuts = cut_generator.randomCut(instance.demands.data(), sum_of_demands, K);
+                sink = sink + cuts.size();
+            });
+        }
+}
+
+void benchParsing(const BenchSettings& settings)
+{
+    for (int N : { 1000, 3000 })
+    {
+        BenchInstance generated = makeInstance(N, N);
+
+        // A unique name in the working directory, so concurrent runs don't share files
+        std::string text = "cvrpbench_" + std::to_string(N) + "_XXXXXX";
+        int fd = mkstemp(&text[0]);
+        FILE* f = fd < 0 ? nullptr : fdopen(fd, "w");
+        if (f == nullptr)
+        {
+            std::cout << "Error: couldn't create a temporary file in the working directory" << std::endl;
+            exit(1);
+        }
+        std::string binary = text + ".vrpb";
+        fprintf(f, "%d %d %.0lf\n", N, N - 1, generated.C);
+        for (const Point& point : generated.points)
+            fprintf(f, "%.0lf %.1lf %.1lf\n", point.d, point.x, point.y);
+        for (int i = 1; i < N; i++)
+        {
+            for (int j = 0; j < i; j++)
+                fprintf(f, j + 1 < i ? "%.5lf " : "%.5lf\n", generated.factors(i, j));
+        }
+        fclose(f);
+
+        // Quiet loads, so printing isn't part of the measured time
+        Instance parsed = instance::readText(text, false);
+        if (!instance::writeBinary(binary, parsed, false))
+        {
+            std::cout << "Error: couldn't write " << binary << std::endl;
+            remove(text.c_str());
+            exit(1);
+        }
+
+        bench(settings, "parse_text", N, "factors", 1, [&]() {
+            Instance instance = instance::readText(text, false);
+            sink = sink + instance.carbonFactor(1, 0);
+        });
+
+        bench(settings, "parse_binary", N, "mapped", 1, [&]() {
+            Instance instance = instance::readBinary(binary, false);
+            sink = sink + instance.carbonFactor(1, 0);
+        });
+
+        remove(text.c_str());
+        remove(binary.c_str());
+    }
+}
+
+// The distance and carbon cost matrices built before the model, and the objective of a solution under both
+void benchObjectives(const BenchSettings& settings)
+{
+    for (int N : { 1000, 5000 })
+    {
+        BenchInstance instance = makeInstance(N, N);
+        double pairs = TriMatrix<double>::count(N);
+
+        bench(settings, "costs", N, "stored_factors", pairs, [&]() {
+            TriMatrix<double> distances(N), carbon_costs(N);
+            for (int i = 1; i < N; i++)
+                for (int j = 0; j < i; j++)
+                {
+                    const Point& a = instance.points[i];
+                    const Point& b = instance.points[j];
+                    distances(i, j) = std::sqrt((a.x - b.x)*(a.x - b.x) + (a.y - b.y)*(a.y - b.y));
+                    carbon_costs(i, j) = instance.factors(i, j) * distances(i, j);
+                }
+            sink = sink + carbon_costs(N - 1, 0);
+        });
+
+        bench(settings, "costs", N, "seeded_factors", pairs, [&]() {
+            TriMatrix<double> distances(N), carbon_costs(N);
+            for (int i = 1; i < N; i++)
+                for (int j = 0; j < i; j++)
+                {
+                    const Point& a = instance.points[i];
+                    const Point& b = instance.points[j];
+                    distances(i, j) = std::sqrt((a.x - b.x)*(a.x - b.x) + (a.y - b.y)*(a.y - b.y));
+                    carbon_costs(i, j) = philox::carbonFactor(N, i, j) * distances(i, j);
+                }
+            sink = sink + carbon_costs(N - 1, 0);
+        });
+
+        TriMatrix<double> distances(N);
+        for (int i = 1; i < N; i++)
+            for (int j = 0; j < i; j++)
+                distances(i, j) = std::hypot(instance.points[i].x - instance.points[j].x, instance.points[i].y - instance.points[j].y);
+        std::mt19937 generator(N);
+        Routes solution = randomSolution(instance, generator);
+
+        bench(settings, "objective", N, "routes", N - 1, [&]() {
+            sink = sink + routes::cost(solution, distances);
+        });
+    }
+}
+
+// Routes out of an integer edge solution, as done with every incumbent and the final solution of each solve
+void benchRouteExtraction(const BenchSettings& settings)
+{
+    for (int N : { 1000, 5000 })
+    {
+        BenchInstance instance = makeInstance(N, N);
+        std::mt19937 generator(N);
+        Routes solution = randomSolution(instance, generator);
+        TriMatrix<double> values = routes::toEdgeValues(solution, N);
+
+        bench(settings, "routes_from_edges", N, "integer", 1, [&]() {
+            Routes extracted = routes::fromEdgeValues(values);
+            sink = sink + extracted.size();
+        });
+
+        bench(settings, "routes_to_edges", N, "integer", 1, [&]() {
+            TriMatrix<double> edges = routes::toEdgeValues(solution, N);
+            sink = sink + edges(solution[0][0], 0);
+        });
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    cxxopts::Options options("CVRPBench", "Microbenchmarks of the solver's kernels that don't need Gurobi");
+    options.add_options()
+        ("o,output", "CSV file with a row for each benchmark", cxxopts::value<std::string>()->default_value("bench_results.csv"))
+        ("t,min-time", "Minimum time in seconds spent on each benchmark", cxxopts::value<double>()->default_value("0.5"))
+        ("f,filter", "Only runs the benchmarks whose name/size/variant contains this text", cxxopts::value<std::string>()->default_value(""))
+        ("h,help", "Prints this page")
+    ;
+
+    auto command_line = options.parse(argc, argv);
+    if (command_line.count("help"))
+    {
+        std::cout << options.help() << std::endl;
+        exit(0);
+    }
+
+    BenchSettings settings;
+    settings.min_time = command_line["min-time"].as<double>();
+    settings.filter = command_line["filter"].as<std::string>();
+    std::string filename = command_line["output"].as<std::string>();
+    settings.output = fopen(filename.c_str(), "w");
+    if (settings.output == nullptr)
+    {
+        std::cout << "Error: couldn't open file " << filename << std::endl;
+        exit(1);
+    }
+
+    fprintf(settings.output, "revision,benchmark,size,variant,runs,ops_per_run,mean_ns_per_op,median_ns_per_op,min_ns_per_op\n");
+    benchUnionFind(settings);
+    benchKarger(settings);
+    benchParsing(settings);
+    benchObjectives(settings);
+    benchRouteExtraction(settings);
+
+    fclose(settings.output);
+    printf("Results of revision %s written to %s\n", REVISION, filename.c_str());
+    return 0;
+}
+
+BenchInstance makeInstance(int N, unsigned int seed)
+{
+    std::mt19937 generator(seed);
+    BenchInstance instance;
+    instance.N = N;
+    instance.factors = TriMatrix<double>(N);
+
+    double total_demand = 0.0;
+    for (int i = 0; i < N; i++)
+    {
+        double d = i == 0 ? 0.0 : 1 + generator() % 10;
+        instance.points.push_back({ (double) (generator() % 1001), (double) (generator() % 1001), d });
+        instance.demands.push_back(d);
+        total_demand += d;
+    }
+
+    // Routes of about 10 clients, with 10% of slack in the capacity
+    instance.C = std::max(10.0, std::ceil(total_demand / (0.9 * std::ceil((N - 1) / 10.0))));
+
+    for (int i = 1; i < N; i++)
+        for (int j = 0; j < i; j++)
+            instance.factors(i, j) = philox::carbonFactor(seed, i, j);
+    return instance;
+}
+
+// A random giant tour split into routes whenever the capacity runs out
+Routes randomSolution(const BenchInstance& instance, std::mt19937& generator)
+{
+    std::vector<int> clients(instance.N - 1);
+    std::iota(clients.begin(), clients.end(), 1);
+    std::shuffle(clients.begin(), clients.end(), generator);
+
+    Routes solution(1);
+    double load = 0.0;
+    for (int client : clients)
+    {
+        if (load + instance.demands[client] > instance.C)
+        {
+            solution.push_back({});
+            load = 0.0;
+        }
+        solution.back().push_back(client);
+        load += instance.demands[client];
+    }
+    return solution;
+}
+
+TriMatrix<double> supportGraph(const BenchInstance& instance, int solutions, unsigned int seed)
+{
+    std::mt19937 generator(seed);
+    TriMatrix<double> support(instance.N);
+    for (int k = 0; k < solutions; k++)
+    {
+        TriMatrix<double> values = routes::toEdgeValues(randomSolution(instance, generator), instance.N);
+        for (int i = 1; i < instance.N; i++)
+            for (int j = 0; j < i; j++)
+                support(i, j) += values(i, j) / solutions;
+    }
+    return support;
+}
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include "binpacking.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace
+{
+
+const double EPS = 1e-9;
+
+int ceilDiv(double a, double C)
+{
+    if (a <= EPS)
+        return 0;
+    return (int) std::ceil(a / C - EPS);
+}
+
+}
+
+int binpacking::lowerBoundL1(const std::vector<double>& items, double C)
+{
+    double total = 0.0;
+    for (double w : items)
+        total += w;
+    return ceilDiv(total, C);
+}
+
+int binpacking::lowerBoundL2(std::vector<double> items, double C)
+{
+    if (items.empty())
+        return 0;
+
+    std::sort(items.begin(), items.end());
+    int n = items.size();
+
+    std::vector<double> prefix(n + 1, 0.0);
+    for (int i = 0; i < n; i++)
+        prefix[i + 1] = prefix[i] + items[i];
+
+    // Index of the first item strictly greater than / greater or equal to a value
+    auto upper = [&](double value) { return (int) (std::upper_bound(items.begin(), items.end(), value + EPS) - items.begin()); };
+    auto lower = [&](double value) { return (int) (std::lower_bound(items.begin(), items.end(), value - EPS) - items.begin()); };
+
+    int half = upper(C / 2);
+    int best = lowerBoundL1(items, C);
+
+    // Only K in {0} U {w_i <= C/2} need to be tried
+    for (int k = -1; k < half; k++)
+    {
+        if (k > 0 && items[k] == items[k - 1])
+            continue;
+        double K = k < 0 ? 0.0 : items[k];
+
+        int j1_start = upper(C - K);              // w > C - K
+        int j3_start = k < 0 ? 0 : lower(K);      // K <= w <= C/2
+
+        int j1 = n - j1_start;
+        int j2 = j1_start - half;
+        double sum_j2 = prefix[j1_start] - prefix[half];
+        double sum_j3 = prefix[half] - prefix[j3_start];
+
+        int bound = j1 + j2 + std::max(0, ceilDiv(sum_j3 - (j2 * C - sum_j2), C));
+        best = std::max(best, bound);
+    }
+
+    return best;
+}
+
+int binpacking::firstFitDecreasing(std::vector<double> items, double C)
+{
+    std::sort(items.begin(), items.end(), std::greater<double>());
+    std::vector<double> residual;
+
+    for (double w : items)
+    {
+        bool placed = false;
+        for (double& r : residual)
+            if (w <= r + EPS)
+            {
+                r -= w;
+                placed = true;
+                break;
+            }
+        if (!placed)
+            residual.push_back(C - w);
+    }
+
+    return residual.size();
+}
+
+int binpacking::exact(std::vector<double> items, double C, int lower_bound, long node_limit)
+{
+    std::sort(items.begin(), items.end(), std::greater<double>());
+    int n = items.size();
+
+    int best = firstFitDecreasing(items, C);
+    if (best <= lower_bound)
+        return best;
+
+    std::vector<double> remaining(n + 1, 0.0);
+    for (int i = n - 1; i >= 0; i--)
+        remaining[i] = remaining[i + 1] + items[i];
+
+    std::vector<double> residual;
+    residual.reserve(n);
+    long nodes = 0;
+    bool aborted = false;
+
+    std::function<void(int)> branch = [&](int i) {
+        if (aborted || best <= lower_bound)
+            return;
+        if (++nodes > node_limit)
+        {
+            aborted = true;
+            return;
+        }
+        if (i == n)
+        {
+            best = std::min<int>(best, residual.size());
+            return;
+        }
+
+        double free_space = 0.0;
+        for (double r : residual)
+            free_space += r;
+        if ((int) residual.size() + ceilDiv(remaining[i] - free_space, C) >= best)
+            return;
+
+        for (unsigned int b = 0; b < residual.size(); b++)
+        {
+            if (items[i] > residual[b] + EPS)
+                continue;
+
+            // Bins with equal residual capacity are interchangeable
+            bool repeated = false;
+            for (unsigned int p = 0; p < b; p++)
+                if (std::fabs(residual[p] - residual[b]) <= EPS)
+                {
+                    repeated = true;
+                    break;
+                }
+            if (repeated)
+                continue;
+
+            residual[b] -= items[i];
+            branch(i + 1);
+            residual[b] += items[i];
+        }
+
+        if ((int) residual.size() + 1 < best)
+        {
+            residual.push_back(C - items[i]);
+            branch(i + 1);
+            residual.pop_back();
+        }
+    };
+
+    branch(0);
+
+    return aborted ? lower_bound : best;
+}
+
+int binpacking::minBins(const std::vector<double>& items, double C, int exact_limit)
+{
+    int bound = lowerBoundL2(items, C);
+    if ((int) items.size() <= exact_limit)
+        bound = std::max(bound, exact(items, C, bound, 100000));
+    return bound;
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#ifndef BINPACKING_HPP
+#define BINPACKING_HPP
+
+#include <vector>
+
+namespace binpacking
+{
+
+// Simple continuous bound, ceil(sum / C)
+int lowerBoundL1(const std::vector<double>& items, double C);
+
+// Martello-Toth L2 bound
+int lowerBoundL2(std::vector<double> items, double C);
+
+int firstFitDecreasing(std::vector<double> items, double C);
+
+// Branch-and-bound for small instances. Returns the optimum if it is found within node_limit, otherwise lower_bound
+int exact(std::vector<double> items, double C, int lower_bound, long node_limit);
+
+// Best available lower bound on the number of bins: L2, tightened by exact() when items.size() <= exact_limit
+int minBins(const std::vector<double>& items, double C, int exact_limit);
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,186 @@
+#include "checkpoint.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+
+const char MAGIC[8] = { 'C', 'V', 'R', 'P', 'C', 'K', 'P', '2' };
+
+template<typename T>
+void put(FILE* f, const T& value)
+{
+    fwrite(&value, sizeof(T), 1, f);
+}
+
+template<typename T>
+void putVector(FILE* f, const std::vector<T>& values)
+{
+    put<unsigned int>(f, values.size());
+    fwrite(values.data(), sizeof(T), values.size(), f);
+}
+
+void putRoutes(FILE* f, const Routes& solution)
+{
+    put<unsigned int>(f, solution.size());
+    for (auto& route : solution)
+        putVector(f, route);
+}
+
+template<typename T>
+bool get(FILE* f, T& value)
+{
+    return fread(&value, sizeof(T), 1, f) == 1;
+}
+
+// Whether what is left of the file, up to end, can hold count elements of the given size.
+// Checked before every resize, so a corrupted length fails the load instead of allocating it.
+bool fits(FILE* f, long end, unsigned int count, size_t element)
+{
+    long position = ftell(f);
+    return position >= 0 && position <= end && count <= (end - position) / element;
+}
+
+template<typename T>
+bool getVector(FILE* f, long end, std::vector<T>& values)
+{
+    unsigned int size;
+    if (!get(f, size) || !fits(f, end, size, sizeof(T)))
+        return false;
+    values.resize(size);
+    return fread(values.data(), sizeof(T), size, f) == size;
+}
+
+bool getRoutes(FILE* f, long end, Routes& solution)
+{
+    unsigned int size;
+    if (!get(f, size) || !fits(f, end, size, sizeof(unsigned int)))
+        return false;
+    solution.resize(size);
+    for (auto& route : solution)
+        if (!getVector(f, end, route))
+            return false;
+    return true;
+}
+
+}
+
+namespace checkpoint
+{
+
+bool save(const std::string& filename, const Checkpoint& state)
+{
+    std::string temporary = filename + ".tmp";
+    FILE* f = fopen(temporary.c_str(), "wb");
+    if (f == nullptr)
+        return false;
+
+    fwrite(MAGIC, 1, sizeof(MAGIC), f);
+    put(f, state.N);
+    put(f, state.C);
+    put(f, state.mode);
+    put(f, state.instance_hash);
+    put(f, state.options_hash);
+    double header[] = { state.best_obj1, state.best_obj2, state.nadir_obj1, state.nadir_obj2, state.scale1, state.scale2, state.range1, state.range2, state.epsilon };
+    fwrite(header, sizeof(double), 9, f);
+    put(f, state.solves);
+
+    put<unsigned int>(f, state.solved.size());
+    for (auto& p : state.solved)
+    {
+        put(f, p.w);
+        put(f, p.bound);
+        const SolveResult& r = p.result;
+        put(f, r.feasible);
+        put(f, r.status);
+        double values[] = { r.distance, r.carbon, r.obj_val, r.obj_bound, r.runtime };
+        fwrite(values, sizeof(double), 5, f);
+        putRoutes(f, r.routes);
+    }
+    putVector(f, state.pending);
+
+    put<unsigned int>(f, state.archive.size());
+    for (auto& p : state.archive)
+    {
+        put(f, p.distance);
+        put(f, p.carbon);
+        putRoutes(f, p.routes);
+    }
+
+    put<unsigned int>(f, state.cuts.size());
+    for (auto& cut : state.cuts)
+    {
+        put(f, cut.rhs);
+        putVector(f, cut.clients);
+    }
+
+    bool ok = !ferror(f);
+    ok = fclose(f) == 0 && ok;
+    return ok && rename(temporary.c_str(), filename.c_str()) == 0;
+}
+
+bool load(const std::string& filename, Checkpoint& state)
+{
+    FILE* f = fopen(filename.c_str(), "rb");
+    if (f == nullptr)
+        return false;
+
+    long end = fseek(f, 0, SEEK_END) == 0 ? ftell(f) : -1;
+    rewind(f);
+
+    char magic[sizeof(MAGIC)];
+    bool ok = end >= 0 && fread(magic, 1, sizeof(MAGIC), f) == sizeof(MAGIC) && memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+    ok = ok && get(f, state.N) && get(f, state.C) && get(f, state.mode) && get(f, state.instance_hash) && get(f, state.options_hash);
+
+    double header[9];
+    ok = ok && fread(header, sizeof(double), 9, f) == 9 && get(f, state.solves);
+    if (ok)
+    {
+        state.best_obj1 = header[0];
+        state.best_obj2 = header[1];
+        state.nadir_obj1 = header[2];
+        state.nadir_obj2 = header[3];
+        state.scale1 = header[4];
+        state.scale2 = header[5];
+        state.range1 = header[6];
+        state.range2 = header[7];
+        state.epsilon = header[8];
+    }
+
+    // Every entry takes at least its fixed part and the count of its routes or clients
+    unsigned int size = 0;
+    ok = ok && get(f, size) && fits(f, end, size, sizeof(weights) + sizeof(double) + sizeof(bool) + sizeof(int) + 5 * sizeof(double) + sizeof(unsigned int));
+    state.solved.resize(ok ? size : 0);
+    for (auto& p : state.solved)
+    {
+        SolveResult& r = p.result;
+        double values[5];
+        ok = ok && get(f, p.w) && get(f, p.bound) && get(f, r.feasible) && get(f, r.status) && fread(values, sizeof(double), 5, f) == 5 && getRoutes(f, end, r.routes);
+        if (!ok)
+            break;
+        r.distance = values[0];
+        r.carbon = values[1];
+        r.obj_val = values[2];
+        r.obj_bound = values[3];
+        r.runtime = values[4];
+    }
+    ok = ok && getVector(f, end, state.pending);
+
+    ok = ok && get(f, size) && fits(f, end, size, 2 * sizeof(double) + sizeof(unsigned int));
+    state.archive.resize(ok ? size : 0);
+    for (auto& p : state.archive)
+        if (!(ok = ok && get(f, p.distance) && get(f, p.carbon) && getRoutes(f, end, p.routes)))
+            break;
+
+    ok = ok && get(f, size) && fits(f, end, size, sizeof(int) + sizeof(unsigned int));
+    state.cuts.resize(ok ? size : 0);
+    for (auto& cut : state.cuts)
+        if (!(ok = ok && get(f, cut.rhs) && getVector(f, end, cut.clients)))
+            break;
+
+    fclose(f);
+    return ok;
+}
+
+}
\ No newline at end of file
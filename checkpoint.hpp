@@ -0,0 +1,40 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cutpool.hpp"
+#include "frontdriver.hpp"
+#include "pareto.hpp"
+
+// Everything needed to continue a front computation: the driver's state, the archive and the cut pool.
+// The fingerprints tell whether it belongs to the same instance and the same front options.
+struct Checkpoint
+{
+    int N;
+    double C;
+    char mode;      // 'l' weight layers, 'n' adaptive weights, 'e' epsilon-constraint
+    uint64_t instance_hash, options_hash;
+    double best_obj1, best_obj2, nadir_obj1, nadir_obj2;
+    double scale1, scale2, range1, range2;
+    std::vector<FrontPoint> solved;
+    std::vector<std::pair<int, int>> pending;   // indices in solved of the parents of every open segment
+    double epsilon;
+    int solves;
+    std::vector<ParetoPoint> archive;
+    std::vector<CapacityCut> cuts;
+};
+
+namespace checkpoint
+{
+
+// Written to a temporary file that then replaces the old checkpoint, so a killed run always leaves a complete one
+bool save(const std::string& filename, const Checkpoint& state);
+bool load(const std::string& filename, Checkpoint& state);
+
+}
+
+#endif
\ No newline at end of file
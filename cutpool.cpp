@@ -0,0 +1,31 @@
+#include "cutpool.hpp"
+
+#include <algorithm>
+
+bool CutPool::add(const std::list<int>& clients, int rhs)
+{
+    std::vector<int> key(clients.begin(), clients.end());
+    std::sort(key.begin(), key.end());
+
+    std::lock_guard<std::mutex> guard(lock);
+    auto found = known.find(key);
+    if (found != known.end() && found->second <= rhs)
+        return false;
+    known[key] = rhs;
+    cuts.push_back({ key, rhs });
+    return true;
+}
+
+std::vector<CapacityCut> CutPool::since(size_t from) const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    if (from >= cuts.size())
+        return {};
+    return std::vector<CapacityCut>(cuts.begin() + from, cuts.end());
+}
+
+size_t CutPool::size() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return cuts.size();
+}
\ No newline at end of file
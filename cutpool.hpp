@@ -0,0 +1,35 @@
+#ifndef CUTPOOL_HPP
+#define CUTPOOL_HPP
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <vector>
+
+// Rounded capacity cut: sum of x_ij over i, j in clients <= rhs
+struct CapacityCut
+{
+    std::vector<int> clients;
+    int rhs;
+};
+
+// Capacity cuts found by every model replica. They depend only on the demands and the capacity,
+// so they stay valid for every scalarization. Safe to share between threads.
+class CutPool
+{
+    private:
+        mutable std::mutex lock;
+        std::vector<CapacityCut> cuts;
+        std::map<std::vector<int>, int> known;     // tightest rhs in the pool for each client set
+
+    public:
+        // Returns false if a cut on the same clients at least as tight (rhs no larger) is already in the pool.
+        // A tighter one is appended rather than replacing the old one, so since() hands it to every replica.
+        bool add(const std::list<int>& clients, int rhs);
+
+        // Cuts added since the first `from`, in insertion order
+        std::vector<CapacityCut> since(size_t from) const;
+        size_t size() const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,537 @@
+#include "cvrpmodel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "binpacking.hpp"
+#include "cutpool.hpp"
+#include "karger.hpp"
+#include "savings.hpp"
+
+// Client sets whose exact fleet size is remembered before the memo starts over
+const size_t MAX_REMEMBERED_BOUNDS = 100000;
+
+class subtourelim: public GRBCallback
+{
+    public:
+        GRBVar** x;
+        GRBVar* edges;
+        int N, V;
+        double C, coefficient;
+        const double* demands;
+        int* spanning_cover_constraints;
+        bool use_log;
+        int min_K, bpp_exact_limit;
+        karger::EdgeVector cut_generator;
+        std::map<std::vector<int>, int> exact_bounds;
+        CutPool* cut_pool = nullptr;
+        ParetoArchive* archive = nullptr;
+        const TriMatrix<double>* distances = nullptr;
+        const TriMatrix<double>* carbon_costs = nullptr;
+        HeuristicWorker* worker = nullptr;
+        localsearch::LocalSearch* search = nullptr;
+        int rounding_frequency = 0, rounding_calls = 0;
+        double rounding_time_share = 0.0, rounding_time = 0.0, rounding_best = std::numeric_limits<double>::infinity();
+        subtourelim(GRBVar** x, GRBVar* edges, const double* demands, int N, int V, double C, double coefficient, bool use_log, int* spanning_cover_constraints, int min_K, int bpp_exact_limit):
+            x(x), edges(edges), N(N), V(V), C(C), demands(demands), cut_generator(N, std::chrono::system_clock::now().time_since_epoch().count()), coefficient(coefficient), use_log(use_log), spanning_cover_constraints(spanning_cover_constraints), min_K(min_K), bpp_exact_limit(bpp_exact_limit) {};
+
+        ~subtourelim() {}
+
+        // Hands a complete solution to the solver as a candidate incumbent
+        void injectSolution(const Routes& solution)
+        {
+            TriMatrix<double> vals = routes::toEdgeValues(solution, N);
+            setSolution(edges, vals.data(), vals.size());
+            useSolution();
+        }
+
+        void resetHeuristics()
+        {
+            rounding_calls = 0;
+            rounding_time = 0.0;
+            rounding_best = std::numeric_limits<double>::infinity();
+        }
+
+        // LP-guided rounding followed by local search, run on every rounding_frequency-th node relaxation
+        // as long as it has used at most rounding_time_share of the solver's runtime
+        void roundRelaxation(const TriMatrix<double>& relaxation)
+        {
+            if (search == nullptr || rounding_frequency <= 0 || rounding_calls++ % rounding_frequency != 0)
+                return;
+            if (rounding_time > rounding_time_share * getDoubleInfo(GRB_CB_RUNTIME))
+                return;
+
+            auto begin = std::chrono::steady_clock::now();
+
+            Routes solution = savings::roundRelaxation(relaxation, search->weightedCosts(), demands, N, C, 0.01);
+            solution = search->improve(solution);
+            double value = search->cost(solution);
+            if (value < rounding_best - 1e-7)
+            {
+                rounding_best = value;
+                injectSolution(solution);
+            }
+
+            rounding_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        }
+        
+        std::vector<double> demandsOf(const std::list<int>& clients) const
+        {
+            std::vector<double> items;
+            items.reserve(clients.size());
+            for (int i : clients)
+                items.push_back(demands[i]);
+            return items;
+        }
+
+        // Martello-Toth L2 bound on the vehicles needed by a subset of clients, cheap enough for every Karger cut
+        int boundVehicles(const std::list<int>& clients) const
+        {
+            return binpacking::lowerBoundL2(demandsOf(clients), C);
+        }
+
+        // Minimum number of vehicles needed to serve a subset of clients, exact for small subsets.
+        // The exact bin packing is remembered per client set, as the same sets come up again and again.
+        int minVehicles(const std::list<int>& clients)
+        {
+            std::vector<int> key(clients.begin(), clients.end());
+            std::sort(key.begin(), key.end());
+            auto known = exact_bounds.find(key);
+            if (known != exact_bounds.end())
+                return known->second;
+
+            int r = binpacking::minBins(demandsOf(clients), C, bpp_exact_limit);
+            if (exact_bounds.size() >= MAX_REMEMBERED_BOUNDS)
+                exact_bounds.clear();
+            exact_bounds.emplace(key, r);
+            return r;
+        }
+
+        // Rounded capacity cut on the clients, also kept in the pool for later solves
+        void addCapacityCut(const std::list<int>& clients, int rhs)
+        {
+            GRBLinExpr c = 0.0;
+            for (auto i = clients.begin(); i != clients.end(); ++i)
+                for (auto j = std::next(i); j != clients.end(); ++j)
+                    c += x[std::max(*i,*j)][std::min(*i,*j)];
+
+            addLazy(c, GRB_LESS_EQUAL, rhs);
+            if (cut_pool != nullptr)
+                cut_pool->add(clients, rhs);
+        }
+
+
+    protected:
+        void callback()
+        {
+            if (where == GRB_CB_MIPSOL)
+            {
+                TriMatrix<double> vals(N);
+                double* values = getSolution(edges, vals.size());
+                std::copy(values, values + vals.size(), vals.data());
+                delete[] values;
+
+                std::vector<bool> seen;
+                for (int i = 0; i < N; i++)
+                    seen.push_back(false);
+                int start, current = 0;
+                double route_demand;
+                bool found_way, feasible = true;
+                Routes solution;
+                
+                // Sweeping through depot routes
+                do {
+                    start = 0;
+                    for (int i = 1; i < N; i++)
+                        if (!seen[i] && vals(i, 0) > 0.5)
+                        {
+                            start = i;
+                            break;
+                        }
+
+                    if (start != 0)
+                    {
+                        std::list<int> tour;
+                        tour.push_back(start);
+                        route_demand = demands[start];
+                        found_way = false;
+                        current = start;
+                        seen[start] = true;
+
+                        do {
+                            found_way = false;
+                            for (int j = 1; j < N; j++)
+                                {
+                                    if (current != j && !seen[j] && vals(current, j) > 0.5)
+                                    {
+                                        found_way = true;
+                                        tour.push_back(j);
+                                        current = j;
+                                        seen[j] = true;
+                                        route_demand += demands[j];
+                                        break;
+                                    }
+                                }
+                        } while(found_way);
+
+                        // if the route exceeds capacity
+                        if (route_demand > C)
+                        {
+                            addCapacityCut(tour, tour.size() - minVehicles(tour));
+                            feasible = false;
+                        }
+                        solution.push_back(std::vector<int>(tour.begin(), tour.end()));
+                    }
+                    
+                } while (start != 0);
+
+                // Sweeping through non-depot routes
+                for (start = 1; start < N; start++)
+                {
+                    if (!seen[start])
+                    {
+                        std::list<int> tour;
+                        tour.push_back(start);
+                        route_demand = demands[start];
+                        seen[start] = true;
+                        current = start;
+
+                        do {
+                            found_way = false;
+                            for (int j = 1; j < N; j++)
+                                {
+                                    if (current != j && !seen[j] && vals(current, j) > 0.5)
+                                    {
+                                        found_way = true;
+                                        tour.push_back(j);
+                                        current = j;
+                                        seen[j] = true;
+                                        route_demand += demands[j];
+                                        break;
+                                    }
+                                }
+                        } while (found_way);
+
+                        addCapacityCut(tour, tour.size() - minVehicles(tour));
+                        feasible = false;
+                    }
+                } 
+
+                // Every incumbent is a CVRP solution worth keeping if no other dominates it
+                if (feasible && archive != nullptr)
+                    archive->insert({ routes::cost(solution, *distances), routes::cost(solution, *carbon_costs), solution });
+
+            }
+            else if (where == GRB_CB_MIPNODE)
+            {
+                Routes heuristic_sol;
+                if (worker != nullptr && worker->poll(heuristic_sol))
+                    injectSolution(heuristic_sol);
+
+                if (getIntInfo(GRB_CB_MIPNODE_STATUS) != GRB_OPTIMAL)
+                    return;
+
+                std::vector<double> sum_of_demands;
+
+                TriMatrix<double> relaxation(N);
+                double* values = getNodeRel(edges, relaxation.size());
+                std::copy(values, values + relaxation.size(), relaxation.data());
+                delete[] values;
+
+                // Karger Setup
+                for (int i = 1; i < N; i++)
+                    for (int j = 1; j < i; j++)
+                        cut_generator.add_edge(i, j, relaxation(i, j));
+
+                // Run Karger 
+                for (int count = 0; count < coefficient * (use_log ? std::log(N) : N); count++)
+                {
+                    sum_of_demands.clear();
+                    auto cuts = cut_generator.randomCut(demands, sum_of_demands, min_K);
+
+                    // Going through each cut, the exact bin packing only runs when L2 isn't enough to show a violation
+                    for (int cut_i = 0; cut_i < cuts.size(); ++cut_i)
+                    {
+                        double current_cut_value = 0.0;
+                        for (auto i = cuts[cut_i].begin(); i != cuts[cut_i].end(); ++i)
+                            for (auto j = std::next(i); j != cuts[cut_i].end(); ++j)
+                                current_cut_value += relaxation(*i, *j);
+
+                        int r = boundVehicles(cuts[cut_i]);
+                        if (current_cut_value <= cuts[cut_i].size() - r && (int) cuts[cut_i].size() <= bpp_exact_limit)
+                            r = minVehicles(cuts[cut_i]);
+
+                        if (current_cut_value > cuts[cut_i].size() - r)
+                            addCapacityCut(cuts[cut_i], cuts[cut_i].size() - r);
+                    }
+                }
+
+                cut_generator.clear_edges();
+
+                roundRelaxation(relaxation);
+            }
+        }
+};
+
+
+CVRPModel::CVRPModel(const Problem& problem, const SolverOptions& options, CutPool& cut_pool, GRBEnv& env):
+    problem(problem), options(options), cut_pool(cut_pool), pooled_cuts(0), N(problem.N), model(nullptr), edges(nullptr), x(nullptr),
+    polisher(*problem.distances, *problem.carbon_costs, problem.demands, problem.N, problem.C, options.granularity, std::chrono::system_clock::now().time_since_epoch().count()),
+    worker(nullptr), cb(nullptr), num_spanning_cover(0)
+{
+    model = new GRBModel(env);
+    model->set(GRB_IntParam_OutputFlag, options.output ? 1 : 0);
+    model->set(GRB_IntParam_LazyConstraints, 1);
+    model->set(GRB_DoubleParam_TimeLimit, options.time_limit);
+    model->set(GRB_IntParam_PoolSolutions, options.pool_solutions);
+    if (options.threads > 0)
+        model->set(GRB_IntParam_Threads, options.threads);
+
+    // x_e variables, kept in one array so their values are read and written with a single call
+    edges = new GRBVar[TriMatrix<double>::count(N)];
+    x = new GRBVar*[N];
+    x[0] = nullptr;
+    for (int i = 1; i < N; i++)
+    {
+        GRBVar *row = edges + TriMatrix<double>::index(i, 0);
+        for (int j = 0; j < i; j++)
+        {
+            std::string varname = "x[" + std::to_string(i) + "][" + std::to_string(j) + "]";
+            double upper_limit = j == 0 ? 2.0 : 1.0;
+            row[j] = model->addVar(0.0, upper_limit, 0, GRB_INTEGER, varname);
+        }
+        x[i] = row;
+    }
+
+    // Degree constraints (clients)
+    for (int i = 1; i < N; i++)
+    {
+        GRBLinExpr c = 0.0;
+        for (int j = 0; j < N; j++)
+            if (i != j)
+                c += x[std::max(i,j)][std::min(i,j)];
+        model->addConstr(c, GRB_EQUAL, 2);
+    }
+
+    // Degree constraints (warehouse)
+    GRBLinExpr c = 0.0;
+    for (int i = 1; i < N; i++)
+        c += x[i][0];
+    model->addConstr(c, GRB_LESS_EQUAL, 2 * problem.V);
+    model->addConstr(c, GRB_GREATER_EQUAL, 2 * problem.min_K);
+
+    // Objectives
+    const TriMatrix<double>& distances = *problem.distances;
+    const TriMatrix<double>& carbon_costs = *problem.carbon_costs;
+
+    for (int i = 1; i < N; i++)
+        for (int j = 0; j < i; j++)
+            obj_distance_traveled += distances(i, j) * x[i][j];
+
+    for (int i = 1; i < N; i++)
+        for (int j = 0; j < i; j++)
+            obj_carbon_emissions += carbon_costs(i, j) * x[i][j];
+
+    // Epsilon constraint on the emissions, kept as a single row whose right-hand side each solve sets
+    carbon_limit = model->addConstr(obj_carbon_emissions, GRB_LESS_EQUAL, GRB_INFINITY, "carbon_limit");
+
+    model->update();
+
+    cb = new subtourelim(x, edges, problem.demands, N, problem.V, problem.C, options.coefficient, options.use_log, &num_spanning_cover, problem.min_K, options.bpp_exact_limit);
+    cb->search = &polisher;
+    cb->cut_pool = &cut_pool;
+    cb->distances = &distances;
+    cb->carbon_costs = &carbon_costs;
+    cb->rounding_frequency = options.rounding_frequency;
+    cb->rounding_time_share = options.rounding_time_share;
+
+    if (options.use_worker)
+    {
+        worker = new HeuristicWorker(distances, carbon_costs, problem.demands, N, problem.C, options.granularity, std::chrono::system_clock::now().time_since_epoch().count());
+        cb->worker = worker;
+    }
+
+    model->setCallback(cb);
+}
+
+CVRPModel::~CVRPModel()
+{
+    delete worker;
+    delete model;
+    delete cb;
+    delete[] edges;
+    delete[] x;
+}
+
+SolveResult CVRPModel::solve(const Scalarization& s, const std::vector<Routes>& initial, ParetoArchive* archive)
+{
+    addPooledCuts();
+
+    double w1 = s.w1 / s.scale1;
+    double w2 = s.w2 / s.scale2;
+
+    GRBVar makespan;
+    GRBConstr makespan_1, makespan_2;
+    if (s.tcheby)
+    {
+        makespan = model->addVar(0.0, std::numeric_limits<double>::infinity(), 0.0, GRB_CONTINUOUS, "D");
+        makespan_1 = model->addConstr(w1 * (obj_distance_traveled - s.ideal1), GRB_LESS_EQUAL, makespan, "makespan_1");
+        makespan_2 = model->addConstr(w2 * (obj_carbon_emissions - s.ideal2), GRB_LESS_EQUAL, makespan, "makespan_2");
+        GRBLinExpr obj_makespan = 0.0;
+        obj_makespan += makespan;
+        model->setObjective(obj_makespan, GRB_MINIMIZE);
+    }
+    else
+    {
+        GRBLinExpr objective = 0.0;
+        if (w1 != 0.0)
+            objective += w1 * (obj_distance_traveled - s.ideal1);
+        if (w2 != 0.0)
+            objective += w2 * (obj_carbon_emissions - s.ideal2);
+        model->setObjective(objective, GRB_MINIMIZE);
+    }
+
+    model->set(GRB_DoubleParam_TimeLimit, std::min(options.time_limit, s.time_limit));
+
+    bool constrained = !std::isinf(s.carbon_limit);
+    carbon_limit.set(GRB_DoubleAttr_RHS, constrained ? s.carbon_limit : GRB_INFINITY);
+
+    // A solution as good as the upper bound is already known, and one matching the lower bound is optimal
+    bool has_upper = !std::isinf(s.upper_bound), has_lower = !std::isinf(s.lower_bound);
+    model->set(GRB_DoubleParam_Cutoff, has_upper ? s.upper_bound + boundTolerance(s.upper_bound) : GRB_INFINITY);
+    model->set(GRB_DoubleParam_BestBdStop, has_upper ? s.upper_bound - boundTolerance(s.upper_bound) : GRB_INFINITY);
+    model->set(GRB_DoubleParam_BestObjStop, has_lower ? s.lower_bound + boundTolerance(s.lower_bound) : -GRB_INFINITY);
+
+    // Heuristics work on the linear part of the scalarization, the background search continues from the best start.
+    // They know nothing of the emissions limit, so constrained solves keep their starts as given and run without the worker.
+    polisher.setWeights(w1, w2);
+    std::vector<Routes> starts;
+    int best_start = -1;
+    for (auto& solution : initial)
+    {
+        if (solution.empty())
+            continue;
+        Routes polished = constrained ? solution : polisher.improve(solution);
+        if (std::find(starts.begin(), starts.end(), polished) != starts.end())
+            continue;
+        starts.push_back(polished);
+        if (best_start < 0 || polisher.cost(polished) < polisher.cost(starts[best_start]))
+            best_start = starts.size() - 1;
+    }
+    setStarts(starts);
+    cb->resetHeuristics();
+
+    bool use_worker = worker != nullptr && best_start >= 0 && !constrained;
+    if (use_worker)
+        worker->start(starts[best_start], w1, w2);
+    cb->archive = archive;
+    model->optimize();
+    cb->archive = nullptr;
+    if (use_worker)
+        worker->stop();
+
+    SolveResult result;
+    result.status = model->get(GRB_IntAttr_Status);
+    result.runtime = model->get(GRB_DoubleAttr_Runtime);
+    result.feasible = model->get(GRB_IntAttr_SolCount) > 0;
+    if (result.feasible)
+    {
+        result.distance = obj_distance_traveled.getValue();
+        result.carbon = obj_carbon_emissions.getValue();
+        result.obj_val = model->get(GRB_DoubleAttr_ObjVal);
+        result.obj_bound = model->get(GRB_DoubleAttr_ObjBound);
+        result.routes = routes::fromEdgeValues(getEdgeValues(GRB_DoubleAttr_X));
+        if (archive != nullptr)
+            harvestPool(*archive);
+    }
+    else if (result.status == GRB_CUTOFF)
+        result.obj_bound = s.upper_bound;
+    else if (result.status == GRB_TIME_LIMIT)
+    {
+        // Only there if the root relaxation was solved in time
+        try
+        {
+            result.obj_bound = model->get(GRB_DoubleAttr_ObjBound);
+        }
+        catch (GRBException e)
+        {
+            result.obj_bound = -INFINITY;
+        }
+    }
+
+    if (s.tcheby)
+    {
+        model->remove(makespan_1);
+        model->remove(makespan_2);
+        model->remove(makespan);
+    }
+
+    return result;
+}
+
+// Cuts found since the last solve, by this replica or any other, as lazy rows that may also cut off relaxations
+void CVRPModel::addPooledCuts()
+{
+    std::vector<CapacityCut> cuts = cut_pool.since(pooled_cuts);
+    for (auto& cut : cuts)
+    {
+        GRBLinExpr c = 0.0;
+        for (size_t a = 0; a < cut.clients.size(); a++)
+            for (size_t b = 0; b < a; b++)
+                c += x[std::max(cut.clients[a], cut.clients[b])][std::min(cut.clients[a], cut.clients[b])];
+
+        GRBConstr row = model->addConstr(c, GRB_LESS_EQUAL, cut.rhs);
+        row.set(GRB_IntAttr_Lazy, 2);
+    }
+    pooled_cuts += cuts.size();
+    model->update();
+}
+
+void CVRPModel::setStarts(const std::vector<Routes>& starts)
+{
+    model->set(GRB_IntAttr_NumStart, std::max<int>(1, starts.size()));
+    model->update();
+
+    for (unsigned int k = 0; k < starts.size(); k++)
+    {
+        TriMatrix<double> vals = routes::toEdgeValues(starts[k], N);
+        model->set(GRB_IntParam_StartNumber, k);
+        model->set(GRB_DoubleAttr_Start, edges, vals.data(), vals.size());
+    }
+
+    // Without any start, the one left from the previous solve is cleared
+    if (starts.empty())
+    {
+        std::vector<double> undefined(TriMatrix<double>::count(N), GRB_UNDEFINED);
+        model->set(GRB_DoubleAttr_Start, edges, undefined.data(), undefined.size());
+    }
+    model->set(GRB_IntParam_StartNumber, 0);
+}
+
+// Solutions left in Gurobi's pool by the last solve
+void CVRPModel::harvestPool(ParetoArchive& archive)
+{
+    int count = model->get(GRB_IntAttr_SolCount);
+    for (int k = 0; k < count; k++)
+    {
+        model->set(GRB_IntParam_SolutionNumber, k);
+        Routes solution = routes::fromEdgeValues(getEdgeValues(GRB_DoubleAttr_Xn));
+        archive.insert({ routes::cost(solution, *problem.distances), routes::cost(solution, *problem.carbon_costs), solution });
+    }
+    model->set(GRB_IntParam_SolutionNumber, 0);
+}
+
+TriMatrix<double> CVRPModel::getEdgeValues(GRB_DoubleAttr attr)
+{
+    TriMatrix<double> vals(N);
+    double* values = model->get(attr, edges, vals.size());
+    std::copy(values, values + vals.size(), vals.data());
+    delete[] values;
+    return vals;
+}
\ No newline at end of file
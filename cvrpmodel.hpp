@@ -0,0 +1,103 @@
+#ifndef CVRPMODEL_HPP
+#define CVRPMODEL_HPP
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "cutpool.hpp"
+#include "gurobi_c++.h"
+#include "heuristicworker.hpp"
+#include "localsearch.hpp"
+#include "pareto.hpp"
+#include "routes.hpp"
+#include "trimatrix.hpp"
+
+// Instance data shared (read only) by every model replica
+struct Problem
+{
+    int N, V, min_K;
+    double C;
+    const double* demands;
+    const TriMatrix<double>* distances;
+    const TriMatrix<double>* carbon_costs;
+};
+
+struct SolverOptions
+{
+    double time_limit, coefficient, rounding_time_share;
+    bool use_log, use_worker, output;
+    int bpp_exact_limit, granularity, rounding_frequency, pool_solutions;
+    int threads;    // Gurobi threads, 0 leaves the default
+};
+
+// Minimizes w1 * (distance - ideal1) / scale1 + w2 * (carbon - ideal2) / scale2,
+// or the largest of the two terms with the Tchebycheff metric, optionally with carbon <= carbon_limit.
+// Known bounds on the optimal value let the solve stop as soon as it can't improve on them,
+// and time_limit shortens the model's own time limit for this solve.
+struct Scalarization
+{
+    double w1, w2;
+    bool tcheby;
+    double ideal1, ideal2;
+    double scale1, scale2;
+    double upper_bound = std::numeric_limits<double>::infinity();
+    double lower_bound = -std::numeric_limits<double>::infinity();
+    double carbon_limit = std::numeric_limits<double>::infinity();
+    double time_limit = std::numeric_limits<double>::infinity();
+};
+
+// Values closer than this are considered equal, the same relative gap Gurobi stops at by default
+inline double boundTolerance(double value)
+{
+    return 1e-4 * std::fabs(value) + 1e-9;
+}
+
+// Without a solution the objectives are infinite, and obj_bound is -inf unless the solver proved a bound
+struct SolveResult
+{
+    bool feasible = false;
+    int status = 0;
+    double distance = INFINITY, carbon = INFINITY;
+    double obj_val = INFINITY, obj_bound = -INFINITY;
+    double runtime = 0.0;
+    Routes routes;
+};
+
+class subtourelim;
+
+// One CVRP model, reused by successive scalarizations
+class CVRPModel
+{
+    private:
+        const Problem& problem;
+        SolverOptions options;
+        CutPool& cut_pool;
+        size_t pooled_cuts;     // How many of the pool's cuts are already rows of the model
+        int N;
+        GRBModel* model;
+        GRBVar* edges;      // x_e in TriMatrix order
+        GRBVar** x;         // rows of edges
+        GRBLinExpr obj_distance_traveled, obj_carbon_emissions;
+        GRBConstr carbon_limit;
+        localsearch::LocalSearch polisher;
+        HeuristicWorker* worker;
+        subtourelim* cb;
+        int num_spanning_cover;
+
+        void addPooledCuts();
+        void setStarts(const std::vector<Routes>& starts);
+        void harvestPool(ParetoArchive& archive);
+        TriMatrix<double> getEdgeValues(GRB_DoubleAttr attr);
+
+    public:
+        // The environment must be started and outlive the model, and no other model may use it at the same time
+        CVRPModel(const Problem& problem, const SolverOptions& options, CutPool& cut_pool, GRBEnv& env);
+        ~CVRPModel();
+
+        // Optimizes a scalarization with the given solutions as MIP starts, after polishing them with the local search.
+        // Every feasible solution met on the way, incumbents and pool solutions, goes into the archive if one is given.
+        SolveResult solve(const Scalarization& s, const std::vector<Routes>& initial, ParetoArchive* archive = nullptr);
+};
+
+#endif
\ No newline at end of file
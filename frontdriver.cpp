@@ -0,0 +1,614 @@
+#include "frontdriver.hpp"
+
+#include <algorithm>
+#include <list>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <queue>
+
+#include "checkpoint.hpp"
+
+namespace
+{
+
+const double INF = std::numeric_limits<double>::infinity();
+
+// FNV-1a over 64-bit words, enough to tell a checkpoint's problem and options from others
+const uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+const uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+uint64_t mix(uint64_t hash, uint64_t word)
+{
+    return (hash ^ word) * FNV_PRIME;
+}
+
+uint64_t mix(uint64_t hash, double value)
+{
+    uint64_t word;
+    memcpy(&word, &value, sizeof(word));
+    return mix(hash, word);
+}
+
+uint64_t mix(uint64_t hash, const double* values, size_t count)
+{
+    for (size_t k = 0; k < count; k++)
+        hash = mix(hash, values[k]);
+    return hash;
+}
+
+// Distinct clients and a right-hand side a model can take, as the cuts become rows over x[i][j]
+bool isValidCut(const CapacityCut& cut, int N)
+{
+    std::vector<bool> seen(N, false);
+    for (int i : cut.clients)
+    {
+        if (i <= 0 || i >= N || seen[i])
+            return false;
+        seen[i] = true;
+    }
+    return cut.rhs >= 1 && cut.rhs < N;
+}
+
+}
+
+FrontDriver::FrontDriver(SolverPool& pool, ParetoArchive& archive, const FrontOptions& options, FILE* csv):
+    pool(pool), archive(archive), options(options), csv(csv),
+    best_obj1(0.0), best_obj2(0.0), nadir_obj1(0.0), nadir_obj2(0.0), scale1(1.0), scale2(1.0), range1(1.0), range2(1.0),
+    epsilon(INF), solves(0), start_time(std::chrono::steady_clock::now()), cut_pool(nullptr), N(0), C(0.0), demands(nullptr), instance_hash(0), starts_per_solve(0) {}
+
+void FrontDriver::setHeuristicStarts(const std::vector<ParetoPoint>& starts, int per_solve)
+{
+    heuristic_starts = starts;
+    starts_per_solve = per_solve;
+}
+
+void FrontDriver::addHeuristicStarts(SolveJob& job, double w1, double w2, double max_carbon) const
+{
+    std::vector<std::pair<double, int>> ranked;
+    for (size_t k = 0; k < heuristic_starts.size(); k++)
+        if (heuristic_starts[k].carbon <= max_carbon)
+            ranked.push_back({ w1 * heuristic_starts[k].distance + w2 * heuristic_starts[k].carbon, k });
+
+    size_t count = std::min<size_t>(std::max(0, starts_per_solve), ranked.size());
+    std::partial_sort(ranked.begin(), ranked.begin() + count, ranked.end());
+    for (size_t k = 0; k < count; k++)
+        job.starts.push_back(heuristic_starts[ranked[k].second].routes);
+}
+
+bool FrontDriver::solveEndpoints(const Routes& distance_start, const Routes& carbon_start)
+{
+    // Each endpoint also starts from the other's solution: the heuristic one when both run in parallel,
+    // the optimal distance solution when they run in sequence
+    SolveJob distance_job = { { 1.0, 0.0, false, 0.0, 0.0, 1.0, 1.0 }, { distance_start, carbon_start } };
+    SolveJob carbon_job = { { 0.0, 1.0, false, 0.0, 0.0, 1.0, 1.0 }, { carbon_start, distance_start } };
+    addHeuristicStarts(distance_job, 1.0, 0.0);
+    addHeuristicStarts(carbon_job, 0.0, 1.0);
+    std::vector<SolveResult> endpoints;
+    double endpoints_time = options.time_budget > 0.0 ? options.endpoint_share * options.time_budget : INF;
+    if (pool.size() > 1)
+    {
+        distance_job.scalarization.time_limit = carbon_job.scalarization.time_limit = endpoints_time;
+        endpoints = pool.solveAll({ distance_job, carbon_job }, archive);
+    }
+    else
+    {
+        // The carbon endpoint gets whatever the distance one didn't use
+        distance_job.scalarization.time_limit = endpoints_time / 2;
+        endpoints = pool.solveAll({ distance_job }, archive);
+        if (endpoints[0].feasible)
+            carbon_job.starts.push_back(endpoints[0].routes);
+        carbon_job.scalarization.time_limit = std::max(0.0, endpoints_time - (options.time_budget - remainingTime()));
+        endpoints.push_back(pool.solveAll({ carbon_job }, archive)[0]);
+    }
+
+    if (!endpoints[0].feasible || !endpoints[1].feasible)
+        return false;
+
+    best_obj1 = endpoints[0].obj_val;
+    nadir_obj2 = endpoints[0].carbon;
+    best_obj2 = endpoints[1].obj_val;
+    nadir_obj1 = endpoints[1].distance;
+
+    if (csv)
+    {
+        fprintf(csv, "%lf,%lf\n", endpoints[0].distance, endpoints[0].carbon);
+        fprintf(csv, "%lf,%lf\n", endpoints[1].distance, endpoints[1].carbon);
+    }
+
+    printf("Minimum distance traveled: %lf\nMinimum carbon emissions: %lf\n", best_obj1, best_obj2);
+
+    scale1 = options.normalize ? (options.use_nadir ? (nadir_obj1 - best_obj1) : best_obj1) : 1.0;
+    scale2 = options.normalize ? (options.use_nadir ? (nadir_obj2 - best_obj2) : best_obj2) : 1.0;
+    range1 = nadir_obj1 - best_obj1 > 1e-9 ? nadir_obj1 - best_obj1 : 1.0;
+    range2 = nadir_obj2 - best_obj2 > 1e-9 ? nadir_obj2 - best_obj2 : 1.0;
+    archive.setReference(nadir_obj1, nadir_obj2);
+
+    solved = {
+        { { 1, 0, 0 }, endpoints[0], (endpoints[0].obj_bound - best_obj1) / scale1 },
+        { { 0, 1, 0 }, endpoints[1], (endpoints[1].obj_bound - best_obj2) / scale2 }
+    };
+    pending = { { 0, 1 } };
+    epsilon = endpoints[0].carbon - options.epsilon_step * range2;
+    solves = 0;
+
+    saveCheckpoint();
+    return true;
+}
+
+double FrontDriver::remainingTime() const
+{
+    if (options.time_budget <= 0.0)
+        return INF;
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    return std::max(0.0, options.time_budget - elapsed);
+}
+
+// Solves given less than a second (or 1% of the budget) would hardly find anything
+bool FrontDriver::outOfTime() const
+{
+    return remainingTime() < std::max(1.0, 0.01 * options.time_budget);
+}
+
+// Splits the time left evenly among the solves still expected, as many at a time as there are replicas, so whatever
+// earlier solves didn't use goes to the later ones. Within a batch, segments with a larger error get a larger share.
+void FrontDriver::assignTimeLimits(std::vector<SolveJob>& jobs, const std::vector<Segment>& segments, double expected_solves) const
+{
+    double remaining = remainingTime();
+    if (std::isinf(remaining) || jobs.empty())
+        return;
+
+    double rounds = std::ceil(std::max(expected_solves, (double) jobs.size()) / pool.size());
+    double share = remaining / rounds;
+
+    double mean_error = 0.0;
+    bool weighted = true;
+    for (auto& segment : segments)
+    {
+        weighted = weighted && !std::isinf(segment.error);
+        mean_error += segment.error / segments.size();
+    }
+    weighted = weighted && mean_error > 0.0;
+
+    for (unsigned int k = 0; k < jobs.size(); k++)
+    {
+        double factor = weighted ? std::min(4.0, std::max(0.25, segments[k].error / mean_error)) : 1.0;
+        jobs[k].scalarization.time_limit = std::min(remaining, share * factor);
+    }
+}
+
+void FrontDriver::enableCheckpoints(const std::string& filename, CutPool& cut_pool, const Problem& problem)
+{
+    checkpoint_file = filename;
+    this->cut_pool = &cut_pool;
+    N = problem.N;
+    C = problem.C;
+    demands = problem.demands;
+
+    // The costs cover the coordinates, the edge weights and the carbon factors
+    instance_hash = mix(mix(mix(FNV_OFFSET, (uint64_t) problem.N), (uint64_t) problem.V), problem.C);
+    instance_hash = mix(instance_hash, problem.demands, problem.N);
+    instance_hash = mix(instance_hash, problem.distances->data(), problem.distances->size());
+    instance_hash = mix(instance_hash, problem.carbon_costs->data(), problem.carbon_costs->size());
+}
+
+char FrontDriver::mode() const
+{
+    return options.epsilon ? 'e' : (options.nise ? 'n' : 'l');
+}
+
+// The options that shape the sequence of scalarizations. The solve limit and the time budget are left out,
+// so a resumed run may be given more of either.
+uint64_t FrontDriver::optionsHash() const
+{
+    uint64_t hash = FNV_OFFSET;
+    hash = mix(hash, (uint64_t) options.tcheby);
+    hash = mix(hash, (uint64_t) options.normalize);
+    hash = mix(hash, (uint64_t) options.use_nadir);
+    hash = mix(hash, (uint64_t) options.max_layers);
+    hash = mix(hash, (uint64_t) options.nise);
+    hash = mix(hash, options.nise_tolerance);
+    hash = mix(hash, (uint64_t) options.hypervolume_priority);
+    hash = mix(hash, (uint64_t) options.epsilon);
+    return mix(hash, options.epsilon_step);
+}
+
+void FrontDriver::saveCheckpoint()
+{
+    if (checkpoint_file.empty())
+        return;
+
+    Checkpoint state = { N, C, mode(), instance_hash, optionsHash(), best_obj1, best_obj2, nadir_obj1, nadir_obj2, scale1, scale2, range1, range2,
+        solved, pending, epsilon, solves, archive.points(), cut_pool->since(0) };
+
+    // The CSV rows of the saved scalarizations are flushed with it, so a resumed run appends after them
+    if (csv)
+        fflush(csv);
+    if (!checkpoint::save(checkpoint_file, state))
+        printf("Warning: couldn't write the checkpoint to %s\n", checkpoint_file.c_str());
+}
+
+bool FrontDriver::resume()
+{
+    Checkpoint state;
+    if (checkpoint_file.empty() || !checkpoint::load(checkpoint_file, state) || state.solved.size() < 2)
+        return false;
+    if (state.N != N || state.C != C || state.instance_hash != instance_hash)
+    {
+        printf("The checkpoint %s belongs to another instance\n", checkpoint_file.c_str());
+        return false;
+    }
+    if (state.mode != mode() || state.options_hash != optionsHash())
+    {
+        printf("The checkpoint %s was saved with other front options\n", checkpoint_file.c_str());
+        return false;
+    }
+
+    for (auto& p : state.pending)
+        if (p.first < 0 || p.second < 0 || p.first >= (int) state.solved.size() || p.second >= (int) state.solved.size())
+            return false;
+
+    // The routes become MIP starts and local search inputs, so each one must serve every client
+    bool valid = true;
+    for (auto& p : state.archive)
+        valid = valid && routes::isFeasible(p.routes, demands, N, C);
+    for (auto& p : state.solved)
+        valid = valid && (p.result.feasible ? routes::isFeasible(p.result.routes, demands, N, C) : p.result.routes.empty());
+    for (auto& cut : state.cuts)
+        valid = valid && isValidCut(cut, N);
+    if (!valid)
+    {
+        printf("The checkpoint %s holds routes or cuts that don't fit the instance\n", checkpoint_file.c_str());
+        return false;
+    }
+
+    best_obj1 = state.best_obj1;
+    best_obj2 = state.best_obj2;
+    nadir_obj1 = state.nadir_obj1;
+    nadir_obj2 = state.nadir_obj2;
+    scale1 = state.scale1;
+    scale2 = state.scale2;
+    range1 = state.range1;
+    range2 = state.range2;
+    solved = state.solved;
+    pending = state.pending;
+    epsilon = state.epsilon;
+    solves = state.solves;
+
+    archive.setReference(nadir_obj1, nadir_obj2);
+    for (auto& p : state.archive)
+        archive.insert(p);
+    for (auto& cut : state.cuts)
+        cut_pool->add(std::list<int>(cut.clients.begin(), cut.clients.end()), cut.rhs);
+
+    printf("Resumed with %zu scalarizations solved and %zu segments open\n", solved.size(), pending.size());
+    return true;
+}
+
+void FrontDriver::run()
+{
+    printf("\n-------------------\n");
+    if (options.epsilon)
+        runEpsilon();
+    else if (options.nise)
+        runNise();
+    else
+        runLayers();
+}
+
+Scalarization FrontDriver::scalarization(const weights& w) const
+{
+    return { w.w1, w.w2, options.tcheby, best_obj1, best_obj2, scale1, scale2 };
+}
+
+double FrontDriver::scalarized(const weights& w, const SolveResult& r) const
+{
+    return w.w1 * (r.distance - best_obj1) / scale1 + w.w2 * (r.carbon - best_obj2) / scale2;
+}
+
+const SolveResult& FrontDriver::betterParent(const weights& w, int a, int b) const
+{
+    const SolveResult& ra = solved[a].result;
+    const SolveResult& rb = solved[b].result;
+    if (!rb.feasible)
+        return ra;
+    if (!ra.feasible)
+        return rb;
+    return scalarized(w, ra) <= scalarized(w, rb) ? ra : rb;
+}
+
+// The weighted sum optimum g(n) = min n.(z - ideal) is concave and positively homogeneous in the weight vector n.
+// The parents' solutions bound it from above, and writing n = alpha n_a + beta n_b with alpha, beta >= 0
+// gives g(n) >= alpha bound_a + beta bound_b. Returns false when these bounds meet, as the segment has no new point.
+bool FrontDriver::makeSegment(int a, int b, weights w, Segment& segment) const
+{
+    segment = { a, b, w, INF, -INF, INF, INF };
+    if (options.tcheby)
+        return true;
+
+    const FrontPoint& pa = solved[a];
+    const FrontPoint& pb = solved[b];
+    if (pa.result.feasible || pb.result.feasible)
+        segment.upper = scalarized(w, betterParent(w, a, b));
+
+    // Weight vectors in objectives normalized by their ranges
+    double n1 = w.w1 * range1 / scale1, n2 = w.w2 * range2 / scale2;
+    double a1 = pa.w.w1 * range1 / scale1, a2 = pa.w.w2 * range2 / scale2;
+    double b1 = pb.w.w1 * range1 / scale1, b2 = pb.w.w2 * range2 / scale2;
+
+    double det = a1 * b2 - b1 * a2;
+    if (std::fabs(det) > 1e-12 && !std::isinf(pa.bound) && !std::isinf(pb.bound))
+    {
+        double alpha = (n1 * b2 - b1 * n2) / det;
+        double beta = (a1 * n2 - n1 * a2) / det;
+        if (alpha >= -1e-12 && beta >= -1e-12)
+            segment.lower = std::max(0.0, alpha) * pa.bound + std::max(0.0, beta) * pb.bound;
+    }
+
+    if (std::isinf(segment.upper) || std::isinf(segment.lower))
+        return true;
+
+    double length = std::hypot((pb.result.distance - pa.result.distance) / range1, (pb.result.carbon - pa.result.carbon) / range2);
+    segment.error = std::max(0.0, segment.upper - segment.lower) / std::hypot(n1, n2);
+    segment.priority = options.hypervolume_priority ? 0.5 * length * segment.error : segment.error;
+
+    return segment.upper - segment.lower > boundTolerance(segment.upper);
+}
+
+// Weights normal to the segment between a and b in the normalized objective space, as in the dichotomic/NISE method.
+// Returns false if the segment is degenerate or its error is already within tolerance.
+bool FrontDriver::makeNiseSegment(int a, int b, Segment& segment) const
+{
+    const SolveResult& ra = solved[a].result;
+    const SolveResult& rb = solved[b].result;
+    if (!ra.feasible || !rb.feasible)
+        return false;
+
+    double du = (rb.distance - ra.distance) / range1;
+    double dv = (ra.carbon - rb.carbon) / range2;
+    if (du <= 1e-9 || dv <= 1e-9)
+        return false;
+
+    double w1 = dv * scale1 / range1;
+    double w2 = du * scale2 / range2;
+    weights w = { w1 / (w1 + w2), w2 / (w1 + w2), std::max(solved[a].w.layer, solved[b].w.layer) + 1 };
+
+    return makeSegment(a, b, w, segment) && segment.error > options.nise_tolerance;
+}
+
+SolveJob FrontDriver::makeJob(const Segment& segment)
+{
+    // Both parents' solutions and the best archived point under the new weights as MIP starts
+    SolveJob job = { scalarization(segment.w), {} };
+    job.scalarization.upper_bound = segment.upper;
+    job.scalarization.lower_bound = segment.lower;
+
+    job.starts.push_back(solved[segment.a].result.routes);
+    job.starts.push_back(solved[segment.b].result.routes);
+    ParetoPoint best_known;
+    if (archive.best(segment.w.w1 / scale1, segment.w.w2 / scale2, best_known))
+        job.starts.push_back(best_known.routes);
+    addHeuristicStarts(job, segment.w.w1 / scale1, segment.w.w2 / scale2);
+
+    return job;
+}
+
+// A solve cut off by the upper bound found nothing better than the better parent
+SolveResult FrontDriver::completeResult(const Segment& segment, const SolveResult& result) const
+{
+    if (result.feasible || std::isinf(segment.upper))
+        return result;
+
+    SolveResult completed = betterParent(segment.w, segment.a, segment.b);
+    completed.obj_val = scalarized(segment.w, completed);
+    completed.obj_bound = result.obj_bound;
+    return completed;
+}
+
+void FrontDriver::report(const weights& w, const SolveResult& r, bool known)
+{
+    printf("Weights (%lf, %lf)%s\n", w.w1, w.w2, known ? " - known from the neighbouring weights" : "");
+    if (r.feasible)
+    {
+        printf("Distance traveled: %lf\n", r.distance);
+        printf("Carbon emission: %lf\n", r.carbon);
+        if (csv)
+            fprintf(csv, "%lf,%lf\n", r.distance, r.carbon);
+    }
+    else
+        printf("No solution found\n");
+    printf("-------------------\n");
+}
+
+// Fixed-depth bisection of the weights, one layer at a time: the midpoints of a layer are independent and solved in parallel
+void FrontDriver::runLayers()
+{
+    while (!pending.empty())
+    {
+        if (outOfTime())
+        {
+            printf("Time budget exhausted with %zu segments open\n", pending.size());
+            break;
+        }
+
+        std::vector<std::pair<int, int>> parents = pending;
+        std::vector<Segment> segments(parents.size());
+        std::vector<SolveResult> results(parents.size());
+        std::vector<SolveJob> jobs;
+        std::vector<int> job_of(parents.size(), -1);
+
+        for (unsigned int k = 0; k < parents.size(); k++)
+        {
+            weights p1 = solved[parents[k].first].w;
+            weights p2 = solved[parents[k].second].w;
+            weights p3 = { (p1.w1 + p2.w1)/2, (p1.w2 + p2.w2)/2, std::max(p1.layer, p2.layer) + 1 };
+
+            if (makeSegment(parents[k].first, parents[k].second, p3, segments[k]))
+            {
+                job_of[k] = jobs.size();
+                jobs.push_back(makeJob(segments[k]));
+            }
+            else
+            {
+                results[k] = betterParent(p3, parents[k].first, parents[k].second);
+                results[k].obj_val = segments[k].upper;
+                results[k].obj_bound = segments[k].lower;
+            }
+        }
+
+        // Each pair may still open the whole subtree of bisections below it
+        std::vector<Segment> solved_segments;
+        double expected_solves = 0.0;
+        for (unsigned int k = 0; k < parents.size(); k++)
+            if (job_of[k] >= 0)
+            {
+                solved_segments.push_back(segments[k]);
+                expected_solves += std::pow(2.0, options.max_layers - segments[k].w.layer + 1) - 1;
+            }
+        assignTimeLimits(jobs, solved_segments, expected_solves);
+
+        std::vector<SolveResult> solve_results = pool.solveAll(jobs, archive);
+
+        std::vector<std::pair<int, int>> next_parents;
+        for (unsigned int k = 0; k < parents.size(); k++)
+        {
+            bool known = job_of[k] < 0;
+            if (!known)
+                results[k] = completeResult(segments[k], solve_results[job_of[k]]);
+
+            weights p3 = segments[k].w;
+            report(p3, results[k], known);
+
+            double bound = results[k].feasible ? results[k].obj_bound : -INF;
+            solved.push_back({ p3, results[k], bound });
+
+            // The optimum is linear over a closed segment, so its halves cannot hold new supported points either
+            if (p3.layer < options.max_layers && !known)
+            {
+                next_parents.push_back({ parents[k].first, (int) solved.size() - 1 });
+                next_parents.push_back({ parents[k].second, (int) solved.size() - 1 });
+            }
+        }
+        pending = next_parents;
+        saveCheckpoint();
+    }
+}
+
+// Adaptive weights: the open segment with the largest error (or possible hypervolume gain) is solved next,
+// as many at a time as there are model replicas, until every segment is within tolerance
+void FrontDriver::runNise()
+{
+    std::priority_queue<Segment> open;
+    for (auto& p : pending)
+    {
+        Segment segment;
+        if (makeNiseSegment(p.first, p.second, segment))
+            open.push(segment);
+    }
+
+    while (!open.empty() && (options.max_solves <= 0 || solves < options.max_solves) && !outOfTime())
+    {
+        // Every segment solved usually opens two more
+        double expected_solves = 2.0 * open.size();
+        if (options.max_solves > 0)
+            expected_solves = std::min(expected_solves, (double) options.max_solves - solves);
+
+        std::vector<Segment> batch;
+        while (!open.empty() && (int) batch.size() < pool.size() && (options.max_solves <= 0 || solves + (int) batch.size() < options.max_solves))
+        {
+            batch.push_back(open.top());
+            open.pop();
+        }
+
+        std::vector<SolveJob> jobs;
+        for (auto& segment : batch)
+            jobs.push_back(makeJob(segment));
+        assignTimeLimits(jobs, batch, expected_solves);
+
+        std::vector<SolveResult> results = pool.solveAll(jobs, archive);
+        solves += batch.size();
+
+        for (unsigned int k = 0; k < batch.size(); k++)
+        {
+            const Segment& segment = batch[k];
+            SolveResult r = completeResult(segment, results[k]);
+            report(segment.w, r, false);
+
+            double bound = r.feasible ? r.obj_bound : -INF;
+            solved.push_back({ segment.w, r, bound });
+            int p = solved.size() - 1;
+
+            // Only a point strictly below the segment splits it, otherwise a and b are adjacent on the front
+            if (r.feasible && scalarized(segment.w, r) < segment.upper - boundTolerance(segment.upper))
+            {
+                Segment left, right;
+                if (makeNiseSegment(segment.a, p, left))
+                    open.push(left);
+                if (makeNiseSegment(p, segment.b, right))
+                    open.push(right);
+            }
+        }
+
+        pending.clear();
+        for (auto remaining = open; !remaining.empty(); remaining.pop())
+            pending.push_back({ remaining.top().a, remaining.top().b });
+        saveCheckpoint();
+    }
+
+    if (!open.empty())
+        printf("Stopped with %zu segments above the tolerance%s\n", open.size(), outOfTime() ? " (time budget exhausted)" : "");
+}
+
+// Minimizes the distance subject to carbon <= epsilon, starting from the distance endpoint and moving epsilon just below
+// each point found, which yields one solve per non-dominated point. A small weight on the emissions keeps weakly
+// dominated points out. Only the emissions row changes between steps, so every cut stays valid, and the minimum
+// emissions solution is a start that is feasible for every epsilon.
+void FrontDriver::runEpsilon()
+{
+    const double rho = 1e-3;
+    double step = options.epsilon_step * range2;
+    weights w = { 1.0, rho, 0 };
+
+    while (epsilon >= best_obj2 - boundTolerance(best_obj2))
+    {
+        if (outOfTime())
+        {
+            printf("Time budget exhausted at epsilon %lf\n", epsilon);
+            break;
+        }
+        SolveJob job = { { 1.0, rho, false, best_obj1, best_obj2, range1, range2 }, { solved[1].result.routes } };
+        job.scalarization.carbon_limit = epsilon;
+
+        // Steps left estimated from how far each step has moved epsilon so far, solved one at a time
+        int steps = solved.size() - 2;
+        double covered = nadir_obj2 - epsilon;
+        double expected_solves = steps > 0 && covered > 0.0 ? std::ceil((epsilon - best_obj2) * steps / covered) + 1 : 10.0;
+        std::vector<SolveJob> jobs = { job };
+        assignTimeLimits(jobs, {}, expected_solves * pool.size());
+        job = jobs[0];
+
+        ParetoPoint best_known;
+        if (archive.best(1.0 / range1, rho / range2, best_known, epsilon))
+        {
+            job.starts.insert(job.starts.begin(), best_known.routes);
+            job.scalarization.upper_bound = (best_known.distance - best_obj1) / range1 + rho * (best_known.carbon - best_obj2) / range2;
+        }
+        addHeuristicStarts(job, 1.0 / range1, rho / range2, epsilon);
+
+        SolveResult r = pool.solveAll({ job }, archive)[0];
+        if (!r.feasible && !std::isinf(job.scalarization.upper_bound))
+            r = { true, r.status, best_known.distance, best_known.carbon, job.scalarization.upper_bound, r.obj_bound, r.runtime, best_known.routes };
+
+        printf("Epsilon %lf\n", epsilon);
+        report(w, r, false);
+
+        if (r.feasible)
+        {
+            solved.push_back({ w, r, -INF });
+            epsilon = std::min(epsilon, r.carbon) - step;
+        }
+        else
+            epsilon = -INF;
+        saveCheckpoint();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#ifndef FRONTDRIVER_HPP
+#define FRONTDRIVER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cutpool.hpp"
+#include "cvrpmodel.hpp"
+#include "pareto.hpp"
+#include "routes.hpp"
+#include "solverpool.hpp"
+
+struct weights
+{
+    double w1, w2;
+    int layer;
+};
+
+struct FrontOptions
+{
+    bool tcheby, normalize, use_nadir;
+    int max_layers;
+
+    // Adaptive (NISE) weights instead of the fixed-depth bisection
+    bool nise;
+    double nise_tolerance;
+    bool hypervolume_priority;
+    int max_solves;     // 0 for no limit
+
+    // Epsilon-constraint sweep instead of weights, with epsilon_step relative to the emissions range
+    bool epsilon;
+    double epsilon_step;
+
+    // Wall-clock budget in seconds for the whole front (0 for none), endpoint_share of it for the endpoints
+    double time_budget;
+    double endpoint_share;
+};
+
+// bound is a lower bound on the optimal value of the point's scalarization
+struct FrontPoint
+{
+    weights w;
+    SolveResult result;
+    double bound;
+};
+
+// Computes the Pareto front by solving a sequence of scalarizations, writing a CSV row for each one
+class FrontDriver
+{
+    private:
+        // A pair of known points and the weights that will be solved between them.
+        // upper and lower bound the scalarization's optimum, error is how far (in objectives normalized
+        // by their ranges) the front between a and b may still be from the segment joining them.
+        struct Segment
+        {
+            int a, b;
+            weights w;
+            double upper, lower;
+            double error, priority;
+
+            bool operator<(const Segment& other) const { return priority < other.priority; }
+        };
+
+        SolverPool& pool;
+        ParetoArchive& archive;
+        FrontOptions options;
+        FILE* csv;
+
+        double best_obj1, best_obj2, nadir_obj1, nadir_obj2;
+        double scale1, scale2;      // normalization of the scalarizations
+        double range1, range2;      // ideal to nadir, used to measure distances on the front
+        std::vector<FrontPoint> solved;
+
+        // Work left: parents of the open segments, next epsilon and solves so far with adaptive weights
+        std::vector<std::pair<int, int>> pending;
+        double epsilon;
+        int solves;
+
+        std::chrono::steady_clock::time_point start_time;
+
+        std::string checkpoint_file;
+        CutPool* cut_pool;
+        int N;
+        double C;
+        const double* demands;
+        uint64_t instance_hash;
+
+        // Solutions from other sources, the best few under each scalarization's weights become its MIP starts
+        std::vector<ParetoPoint> heuristic_starts;
+        int starts_per_solve;
+
+        Scalarization scalarization(const weights& w) const;
+        double scalarized(const weights& w, const SolveResult& r) const;
+        const SolveResult& betterParent(const weights& w, int a, int b) const;
+        SolveJob makeJob(const Segment& segment);
+        void addHeuristicStarts(SolveJob& job, double w1, double w2, double max_carbon = std::numeric_limits<double>::infinity()) const;
+        SolveResult completeResult(const Segment& segment, const SolveResult& result) const;
+        bool makeSegment(int a, int b, weights w, Segment& segment) const;
+        bool makeNiseSegment(int a, int b, Segment& segment) const;
+        void report(const weights& w, const SolveResult& r, bool known);
+        char mode() const;
+        uint64_t optionsHash() const;
+        double remainingTime() const;
+        bool outOfTime() const;
+        void assignTimeLimits(std::vector<SolveJob>& jobs, const std::vector<Segment>& segments, double expected_solves) const;
+        void saveCheckpoint();
+
+        void runLayers();
+        void runNise();
+        void runEpsilon();
+
+    public:
+        // csv may be null when the rows aren't needed
+        FrontDriver(SolverPool& pool, ParetoArchive& archive, const FrontOptions& options, FILE* csv);
+
+        // Minimizes each objective on its own, false if either has no solution
+        bool solveEndpoints(const Routes& distance_start, const Routes& carbon_start);
+        void run();
+
+        // Offers each scalarization, endpoints included, the per_solve best of these solutions as MIP starts
+        void setHeuristicStarts(const std::vector<ParetoPoint>& starts, int per_solve);
+
+        // Saves the state after the endpoints and after every batch of scalarizations, with a fingerprint of the problem
+        void enableCheckpoints(const std::string& filename, CutPool& cut_pool, const Problem& problem);
+
+        // Continues from the checkpoint instead of solving the endpoints, restoring the archive and the cut pool.
+        // False if it can't be read or belongs to another instance, front generation mode or set of front options.
+        bool resume();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include "frontstream.hpp"
+
+#include <stdexcept>
+
+#include <unistd.h>
+
+namespace
+{
+
+FILE* openFile(const std::string& filename, bool append)
+{
+    return fopen(filename.c_str(), append ? "ab" : "wb");
+}
+
+void sync(FILE* f)
+{
+    fflush(f);
+    fsync(fileno(f));
+}
+
+}
+
+FrontStream::FrontStream(): csv(nullptr), routes_file(nullptr), index(nullptr), offset(0), done(false) {}
+
+FrontStream::~FrontStream()
+{
+    if (!isOpen())
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        done = true;
+    }
+    ready.notify_one();
+    thread.join();
+
+    fclose(csv);
+    fclose(routes_file);
+    fclose(index);
+}
+
+void FrontStream::open(const std::string& base, bool append)
+{
+    // All three or none, so a stream that failed to open stays closed
+    FILE* csv_file = openFile(base + ".csv", append);
+    FILE* routes = csv_file ? openFile(base + ".routes", append) : nullptr;
+    FILE* index_file = routes ? openFile(base + ".idx", append) : nullptr;
+    if (index_file == nullptr)
+    {
+        std::string failed = base + (csv_file == nullptr ? ".csv" : (routes == nullptr ? ".routes" : ".idx"));
+        if (csv_file)
+            fclose(csv_file);
+        if (routes)
+            fclose(routes);
+        throw std::runtime_error("couldn't open file " + failed);
+    }
+
+    csv = csv_file;
+    routes_file = routes;
+    index = index_file;
+
+    fseek(routes_file, 0, SEEK_END);
+    offset = ftell(routes_file);
+
+    thread = std::thread(&FrontStream::run, this);
+}
+
+bool FrontStream::isOpen() const
+{
+    return csv != nullptr;
+}
+
+void FrontStream::push(const ParetoPoint& point)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        queue.push_back(point);
+    }
+    ready.notify_one();
+}
+
+void FrontStream::run()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    while (true)
+    {
+        ready.wait(guard, [this]() { return done || !queue.empty(); });
+        if (queue.empty())
+            return;
+
+        ParetoPoint point = std::move(queue.front());
+        queue.pop_front();
+
+        // The solver threads keep pushing while the point is written
+        guard.unlock();
+        write(point);
+        guard.lock();
+    }
+}
+
+void FrontStream::write(const ParetoPoint& point)
+{
+    uint64_t start = offset;
+
+    int32_t count = point.routes.size();
+    fwrite(&count, sizeof(count), 1, routes_file);
+    offset += sizeof(count);
+    for (const std::vector<int>& route : point.routes)
+    {
+        int32_t length = route.size();
+        fwrite(&length, sizeof(length), 1, routes_file);
+        for (int client : route)
+        {
+            int32_t c = client;
+            fwrite(&c, sizeof(c), 1, routes_file);
+        }
+        offset += sizeof(length) + length * sizeof(int32_t);
+    }
+    sync(routes_file);
+
+    fwrite(&start, sizeof(start), 1, index);
+    sync(index);
+
+    fprintf(csv, "%lf,%lf\n", point.distance, point.carbon);
+    sync(csv);
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef FRONTSTREAM_HPP
+#define FRONTSTREAM_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "pareto.hpp"
+
+// Writes every point the archive accepts, as soon as it is found, so other programs can follow the run:
+//     <base>.csv      distance,carbon of each point, in the order they were found
+//     <base>.routes   routes of each point: int32 number of routes, then each one as int32 length and clients
+//     <base>.idx      uint64 offset in <base>.routes of the k-th point's routes, at byte 8k
+// A background thread writes them and syncs each point to disk, routes and index first, so a CSV row is
+// never seen before its routes. Later points may dominate earlier ones.
+class FrontStream
+{
+    private:
+        FILE *csv, *routes_file, *index;
+        uint64_t offset;
+
+        std::thread thread;
+        std::mutex lock;
+        std::condition_variable ready;
+        std::deque<ParetoPoint> queue;
+        bool done;
+
+        void run();
+        void write(const ParetoPoint& point);
+
+    public:
+        FrontStream();
+        ~FrontStream();
+
+        // Does nothing until opened. With append the files of an earlier run are continued.
+        // Throws std::runtime_error, leaving the stream closed, if any of the files can't be opened.
+        void open(const std::string& base, bool append);
+        bool isOpen() const;
+
+        // Safe to call from any thread, the point is written later by the background thread
+        void push(const ParetoPoint& point);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,249 @@
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+#include "instance.hpp"
+#include "philox.hpp"
+#include "trimatrix.hpp"
+#include "cxxopts/cxxopts.hpp"
+
+const double GRID = 1000.0;
+
+// Uniform draws from Philox, so the same seed gives the same instance with any compiler and standard library.
+// Each stream (coordinates, demands, ...) has its own counters, so changing how one is drawn doesn't change the others.
+class Draws
+{
+    private:
+        philox::Key key;
+        uint32_t stream, block;
+        philox::Counter bits;
+        int used;
+
+    public:
+        Draws(uint64_t seed, uint32_t stream): key({ (uint32_t) seed, (uint32_t) (seed >> 32) }), stream(stream), block(0), used(4) {}
+
+        // In [0, 1)
+        double uniform()
+        {
+            if (used == 4)
+            {
+                bits = philox::generate({ block++, stream, 0, 0 }, key);
+                used = 0;
+            }
+            return bits[used++] * (1.0 / 4294967296.0);
+        }
+
+        // In [low, high]
+        int integer(int low, int high)
+        {
+            return low + std::min<int>(high - low, uniform() * (high - low + 1));
+        }
+
+        double normal()
+        {
+            double u = 1.0 - uniform();
+            return std::sqrt(-2.0 * std::log(u)) * std::cos(2.0 * M_PI * uniform());
+        }
+};
+
+Point drawClustered(Draws& draws, const std::vector<Point>& centers, double spread);
+double drawDemand(Draws& draws, const std::string& distribution, const Point& point);
+void writeText(const std::string& filename, const Instance& instance, bool stored_factors);
+
+int main(int argc, char *argv[])
+{
+    cxxopts::Options options("CVRPGenerator", "Generates CVRP instances with reproducible random layouts and demands");
+    options.add_options()
+        ("o,output", "Output file, in the binary format if it ends in .vrpb and in the text format otherwise", cxxopts::value<std::string>())
+        ("n,vertices", "Number of vertices, the depot included", cxxopts::value<int>()->default_value("1000"))
+        ("l,layout", "Placement of the clients: uniform, clustered or mixed (half of each)", cxxopts::value<std::string>()->default_value("uniform"))
+        ("clusters", "Number of clusters, 0 to draw it from [3, 8]", cxxopts::value<int>()->default_value("0"))
+        ("cluster-spread", "Standard deviation of the distance from a client to its cluster's center", cxxopts::value<double>()->default_value("40.0"))
+        ("p,depot", "Position of the depot: center, corner or random", cxxopts::value<std::string>()->default_value("center"))
+        ("d,demands", "Demand distribution: unit, small [1, 10], large [5, 100], skewed (mostly [1, 10], a few [50, 100]) or quadrant ([1, 50] or [51, 100] by quadrant)", cxxopts::value<std::string>()->default_value("small"))
+        ("r,route-size", "Average number of clients per route, which sets the number of vehicles", cxxopts::value<double>()->default_value("10.0"))
+        ("t,tightness", "Total demand over the total capacity of the vehicles, which sets the capacity", cxxopts::value<double>()->default_value("0.9"))
+        ("s,seed", "Seed of every random choice", cxxopts::value<uint64_t>()->default_value("1"))
+        ("c,carbon-factors", "Carbon factors: seeded (only the seed is written, the solver generates them) or stored (written in full)", cxxopts::value<std::string>()->default_value("seeded"))
+        ("h,help", "Prints this page")
+    ;
+
+    auto command_line = options.parse(argc, argv);
+    if (command_line.count("help") || !command_line.count("output"))
+    {
+        std::cout << options.help() << std::endl;
+        exit(command_line.count("help") ? 0 : 1);
+    }
+
+    std::string output = command_line["output"].as<std::string>();
+    int N = command_line["vertices"].as<int>();
+    std::string layout = command_line["layout"].as<std::string>();
+    std::string depot = command_line["depot"].as<std::string>();
+    std::string distribution = command_line["demands"].as<std::string>();
+    std::string factors = command_line["carbon-factors"].as<std::string>();
+    double route_size = command_line["route-size"].as<double>();
+    double tightness = command_line["tightness"].as<double>();
+    double spread = command_line["cluster-spread"].as<double>();
+    uint64_t seed = command_line["seed"].as<uint64_t>();
+
+    if (N < 2)
+    {
+        std::cout << "Error: an instance needs the depot and at least one client" << std::endl;
+        exit(1);
+    }
+    if (layout != "uniform" && layout != "clustered" && layout != "mixed")
+    {
+        std::cout << "Error: unknown layout " << layout << std::endl;
+        exit(1);
+    }
+    if (depot != "center" && depot != "corner" && depot != "random")
+    {
+        std::cout << "Error: unknown depot position " << depot << std::endl;
+        exit(1);
+    }
+    if (distribution != "unit" && distribution != "small" && distribution != "large" && distribution != "skewed" && distribution != "quadrant")
+    {
+        std::cout << "Error: unknown demand distribution " << distribution << std::endl;
+        exit(1);
+    }
+    if (factors != "seeded" && factors != "stored")
+    {
+        std::cout << "Error: carbon factors must be seeded or stored" << std::endl;
+        exit(1);
+    }
+    if (route_size <= 0.0 || tightness <= 0.0 || tightness > 1.0)
+    {
+        std::cout << "Error: the route size must be positive and the tightness in (0, 1]" << std::endl;
+        exit(1);
+    }
+
+    Draws layout_draws(seed, 0), demand_draws(seed, 1);
+
+    Instance instance;
+    instance.N = N;
+    instance.points.resize(N);
+    if (depot == "center")
+        instance.points[0] = { GRID / 2, GRID / 2, 0.0 };
+    else if (depot == "corner")
+        instance.points[0] = { 0.0, 0.0, 0.0 };
+    else
+        instance.points[0] = { (double) layout_draws.integer(0, GRID), (double) layout_draws.integer(0, GRID), 0.0 };
+
+    std::vector<Point> centers;
+    if (layout != "uniform")
+    {
+        int clusters = command_line["clusters"].as<int>();
+        if (clusters <= 0)
+            clusters = layout_draws.integer(3, 8);
+        for (int k = 0; k < clusters; k++)
+            centers.push_back({ (double) layout_draws.integer(0, GRID), (double) layout_draws.integer(0, GRID), 0.0 });
+    }
+
+    // Mixed layouts place the first half of the clients in clusters
+    int clustered = layout == "uniform" ? 0 : (layout == "clustered" ? N - 1 : (N - 1) / 2);
+    double total_demand = 0.0, max_demand = 0.0;
+    for (int i = 1; i < N; i++)
+    {
+        Point& point = instance.points[i];
+        if (i <= clustered)
+            point = drawClustered(layout_draws, centers, spread);
+        else
+            point = { (double) layout_draws.integer(0, GRID), (double) layout_draws.integer(0, GRID), 0.0 };
+
+        point.d = drawDemand(demand_draws, distribution, point);
+        total_demand += point.d;
+        max_demand = std::max(max_demand, point.d);
+    }
+
+    instance.V = std::max<int>(1, std::ceil((N - 1) / route_size));
+    instance.C = std::max(max_demand, std::ceil(total_demand / (tightness * instance.V)));
+
+    instance.procedural_factors = true;
+    instance.carbon_seed = seed;
+    if (factors == "stored")
+    {
+        instance.carbon_factors = TriMatrix<double>(N);
+        for (int i = 1; i < N; i++)
+            for (int j = 0; j < i; j++)
+                instance.carbon_factors(i, j) = philox::carbonFactor(seed, i, j);
+        instance.procedural_factors = false;
+    }
+
+    if (output.size() > 5 && output.compare(output.size() - 5, 5, ".vrpb") == 0)
+    {
+        if (!instance::writeBinary(output, instance, false))
+        {
+            std::cout << "Error: couldn't write " << output << std::endl;
+            exit(1);
+        }
+    }
+    else
+        writeText(output, instance, factors == "stored");
+
+    printf("%s: %d vertices, %d vehicles of capacity %.0lf, total demand %.0lf (tightness %.3lf)\n",
+        output.c_str(), N, instance.V, instance.C, total_demand, total_demand / (instance.V * instance.C));
+    return 0;
+}
+
+// A uniformly chosen center plus a normal offset, drawn again until it falls in the grid
+Point drawClustered(Draws& draws, const std::vector<Point>& centers, double spread)
+{
+    const Point& center = centers[draws.integer(0, centers.size() - 1)];
+    while (true)
+    {
+        double x = std::round(center.x + spread * draws.normal());
+        double y = std::round(center.y + spread * draws.normal());
+        if (x >= 0.0 && x <= GRID && y >= 0.0 && y <= GRID)
+            return { x, y, 0.0 };
+    }
+}
+
+double drawDemand(Draws& draws, const std::string& distribution, const Point& point)
+{
+    if (distribution == "unit")
+        return 1.0;
+    if (distribution == "small")
+        return draws.integer(1, 10);
+    if (distribution == "large")
+        return draws.integer(5, 100);
+    if (distribution == "skewed")
+        return draws.uniform() < 0.8 ? draws.integer(1, 10) : draws.integer(50, 100);
+
+    // Quadrant: large demands in the first and third quadrants around the grid's center
+    bool odd = (point.x >= GRID / 2) == (point.y >= GRID / 2);
+    return odd ? draws.integer(51, 100) : draws.integer(1, 50);
+}
+
+void writeText(const std::string& filename, const Instance& instance, bool stored_factors)
+{
+    FILE* f = fopen(filename.c_str(), "w");
+    if (f == nullptr)
+    {
+        std::cout << "Error: couldn't open file " << filename << std::endl;
+        exit(1);
+    }
+
+    if (stored_factors)
+        fprintf(f, "%d %d %.0lf\n", instance.N, instance.V, instance.C);
+    else
+        fprintf(f, "%d %d %.0lf %lu\n", instance.N, instance.V, instance.C, (unsigned long) instance.carbon_seed);
+
+    for (const Point& point : instance.points)
+        fprintf(f, "%.0lf %.1lf %.1lf\n", point.d, point.x, point.y);
+
+    // Five decimals, like utils/carbon_adder.py
+    if (stored_factors)
+        for (int i = 1; i < instance.N; i++)
+        {
+            fprintf(f, "\n");
+            for (int j = 0; j < i; j++)
+                fprintf(f, j + 1 < i ? "%.5lf " : "%.5lf", instance.carbon_factors(i, j));
+        }
+    fprintf(f, "\n");
+
+    fclose(f);
+}
\ No newline at end of file
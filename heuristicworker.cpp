@@ -0,0 +1,161 @@
+#include "heuristicworker.hpp"
+
+#include <algorithm>
+
+HeuristicWorker::HeuristicWorker(const TriMatrix<double>& distances, const TriMatrix<double>& carbon_costs, const double* demands, int N, double C, int granularity, unsigned int seed):
+    N(N), C(C), demands(demands), search(distances, carbon_costs, demands, N, C, granularity, seed), generator(seed), running(false), found(64) {}
+
+HeuristicWorker::~HeuristicWorker()
+{
+    stop();
+}
+
+void HeuristicWorker::start(const Routes& solution, double w1, double w2)
+{
+    stop();
+
+    Routes discarded;
+    while (found.pop(discarded));
+
+    search.setWeights(w1, w2);
+    start_solution = solution;
+    running = true;
+    thread = std::thread(&HeuristicWorker::run, this);
+}
+
+void HeuristicWorker::stop()
+{
+    running = false;
+    if (thread.joinable())
+        thread.join();
+}
+
+bool HeuristicWorker::poll(Routes& solution)
+{
+    bool any = false;
+    while (found.pop(solution))
+        any = true;
+    return any;
+}
+
+void HeuristicWorker::run()
+{
+    double start_cost = search.cost(start_solution);
+    Routes current = search.improve(start_solution);
+    double current_cost = search.cost(current);
+    Routes best = current;
+    double best_cost = current_cost;
+
+    if (best_cost < start_cost - 1e-7)
+        found.push(Routes(best));
+
+    int since_improvement = 0;
+    while (running)
+    {
+        Routes candidate = search.improve(perturb(current));
+        double candidate_cost = search.cost(candidate);
+
+        if (candidate_cost < best_cost - 1e-7)
+        {
+            best = candidate;
+            best_cost = candidate_cost;
+            since_improvement = 0;
+            found.push(Routes(best));
+        }
+        else
+            ++since_improvement;
+
+        // Threshold acceptance, going back to the best solution after a long stagnation
+        if (candidate_cost < best_cost * 1.01)
+        {
+            current = candidate;
+            current_cost = candidate_cost;
+        }
+        if (since_improvement > 200)
+        {
+            current = best;
+            current_cost = best_cost;
+            since_improvement = 0;
+        }
+    }
+}
+
+// Removes a random client together with some of its closest neighbours and reinserts them at their cheapest feasible positions
+Routes HeuristicWorker::perturb(const Routes& solution)
+{
+    std::uniform_int_distribution<int> client_dist(1, N - 1);
+    std::uniform_int_distribution<int> size_dist(2, std::max(3, std::min(30, N / 10)));
+
+    int seed_client = client_dist(generator);
+    int size = size_dist(generator);
+
+    std::vector<bool> removed(N, false);
+    std::vector<int> removed_clients = { seed_client };
+    removed[seed_client] = true;
+    for (int v : search.closest(seed_client))
+    {
+        if ((int) removed_clients.size() >= size)
+            break;
+        removed[v] = true;
+        removed_clients.push_back(v);
+    }
+
+    Routes partial;
+    std::vector<double> loads;
+    for (auto& route : solution)
+    {
+        std::vector<int> kept;
+        double load = 0.0;
+        for (int i : route)
+            if (!removed[i])
+            {
+                kept.push_back(i);
+                load += demands[i];
+            }
+        if (!kept.empty())
+        {
+            partial.push_back(kept);
+            loads.push_back(load);
+        }
+    }
+
+    std::shuffle(removed_clients.begin(), removed_clients.end(), generator);
+    for (int u : removed_clients)
+    {
+        int best_route = -1, best_position = 0;
+        double best_delta = 2 * search.cost(0, u);
+
+        for (unsigned int r = 0; r < partial.size(); r++)
+        {
+            if (loads[r] + demands[u] > C + 1e-9)
+                continue;
+
+            auto& route = partial[r];
+            for (unsigned int k = 0; k <= route.size(); k++)
+            {
+                int before = k == 0 ? 0 : route[k - 1];
+                int after = k == route.size() ? 0 : route[k];
+                double delta = search.cost(before, u) + search.cost(u, after) - search.cost(before, after);
+                if (delta < best_delta)
+                {
+                    best_delta = delta;
+                    best_route = r;
+                    best_position = k;
+                }
+            }
+        }
+
+        if (best_route < 0)
+        {
+            partial.push_back({ u });
+            loads.push_back(demands[u]);
+        }
+        else
+        {
+            partial[best_route].insert(partial[best_route].begin() + best_position, u);
+            loads[best_route] += demands[u];
+        }
+    }
+
+    return partial;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef HEURISTICWORKER_HPP
+#define HEURISTICWORKER_HPP
+
+#include <atomic>
+#include <random>
+#include <thread>
+
+#include "localsearch.hpp"
+#include "routes.hpp"
+#include "spscqueue.hpp"
+#include "trimatrix.hpp"
+
+// Iterated local search running in a background thread while the solver works.
+// Every new best solution is pushed to a single producer/single consumer queue
+// that the solver callback drains.
+class HeuristicWorker
+{
+    private:
+        int N;
+        double C;
+        const double* demands;
+        localsearch::LocalSearch search;
+        std::default_random_engine generator;
+
+        std::thread thread;
+        std::atomic<bool> running;
+        SPSCQueue<Routes> found;
+        Routes start_solution;
+
+        void run();
+        Routes perturb(const Routes& solution);
+
+    public:
+        HeuristicWorker(const TriMatrix<double>& distances, const TriMatrix<double>& carbon_costs, const double* demands, int N, double C, int granularity, unsigned int seed);
+        ~HeuristicWorker();
+
+        // Starts searching from a solution for the costs w1 * distance + w2 * carbon
+        void start(const Routes& solution, double w1, double w2);
+        void stop();
+
+        // Consumer side: best solution pushed since the last call, if any
+        bool poll(Routes& solution);
+};
+
+#endif
\ No newline at end of file
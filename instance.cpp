@@ -0,0 +1,520 @@
+#include "instance.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <thread>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mappedfile.hpp"
+
+namespace
+{
+
+const char MAGIC[4] = { 'V', 'R', 'P', 'B' };
+const uint32_t VERSION = 3;
+
+struct BinaryHeader
+{
+    char magic[4];
+    uint32_t version;
+    int32_t N, V;
+    double C;
+    uint32_t factor_size;       // 8 for doubles, 4 for floats
+    uint32_t edge_weights;      // 1 if the edge weights (as doubles) come before the factors
+    int64_t source_size, source_mtime;      // of the text file the cache was built from, 0 otherwise
+    uint32_t procedural_factors;            // 1 if there are no factors, only the seed
+    uint32_t reserved;
+    uint64_t carbon_seed;
+};
+
+bool fileStamp(const std::string& filename, int64_t& size, int64_t& mtime)
+{
+    struct stat info;
+    if (stat(filename.c_str(), &info) != 0)
+        return false;
+    size = info.st_size;
+    mtime = (int64_t) info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+    return true;
+}
+
+// The header of a binary file, false if it isn't one this version can read
+bool readHeader(const MappedFile& file, BinaryHeader& header)
+{
+    if (file.size() < sizeof(BinaryHeader))
+        return false;
+    memcpy(&header, file.data(), sizeof(BinaryHeader));
+    if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION || header.N < 2 || header.V < 1 || !(header.C > 0.0))
+        return false;
+    if ((header.factor_size != sizeof(double) && header.factor_size != sizeof(float)) || header.edge_weights > 1 || header.procedural_factors > 1)
+        return false;
+    size_t count = TriMatrix<double>::count(header.N);
+    size_t factor_size = header.procedural_factors ? 0 : header.factor_size;
+    return file.size() == sizeof(BinaryHeader) + header.N * sizeof(Point) + count * (header.edge_weights * sizeof(double) + factor_size);
+}
+
+bool writeFile(const std::string& filename, const Instance& instance, bool single_precision, int64_t source_size, int64_t source_mtime)
+{
+    BinaryHeader header;
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.N = instance.N;
+    header.V = instance.V;
+    header.C = instance.C;
+    header.factor_size = single_precision ? sizeof(float) : sizeof(double);
+    header.edge_weights = instance.edge_weights.dimension() > 0 ? 1 : 0;
+    header.source_size = source_size;
+    header.source_mtime = source_mtime;
+    header.procedural_factors = instance.procedural_factors ? 1 : 0;
+    header.reserved = 0;
+    header.carbon_seed = instance.carbon_seed;
+
+    // Runs of a batch may write the cache of the same instance at the same time
+    std::string temporary = filename + "." + std::to_string(getpid()) + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+    FILE* f = fopen(temporary.c_str(), "wb");
+    if (f == nullptr)
+        return false;
+
+    fwrite(&header, sizeof(header), 1, f);
+    fwrite(instance.points.data(), sizeof(Point), instance.N, f);
+    size_t count = TriMatrix<double>::count(instance.N);
+    if (header.edge_weights)
+        fwrite(instance.edge_weights.data(), sizeof(double), count, f);
+    if (!instance.procedural_factors)
+    {
+        if (single_precision)
+        {
+            std::vector<float> factors(count);
+            for (size_t k = 0; k < count; k++)
+                factors[k] = instance.carbon_factors.dimension() > 0 ? instance.carbon_factors.data()[k] : instance.carbon_factors_single.data()[k];
+            fwrite(factors.data(), sizeof(float), count, f);
+        }
+        else if (instance.carbon_factors.dimension() > 0)
+            fwrite(instance.carbon_factors.data(), sizeof(double), count, f);
+        else
+        {
+            std::vector<double> factors(instance.carbon_factors_single.data(), instance.carbon_factors_single.data() + count);
+            fwrite(factors.data(), sizeof(double), count, f);
+        }
+    }
+
+    bool ok = !ferror(f);
+    ok = fclose(f) == 0 && ok;
+    if (!ok || rename(temporary.c_str(), filename.c_str()) != 0)
+    {
+        remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Whitespace separated numbers, keeping track of the line for error messages
+class Tokenizer
+{
+    private:
+        const std::string& filename;
+        const char* current;
+        const char* end;
+        int line;
+
+        void skipSpaces()
+        {
+            while (current < end && (*current == ' ' || *current == '\t' || *current == '\r' || *current == '\n'))
+            {
+                if (*current == '\n')
+                    ++line;
+                ++current;
+            }
+        }
+
+    public:
+        Tokenizer(const std::string& filename, const char* begin, const char* end):
+            filename(filename), current(begin), end(end), line(1) {}
+
+        [[noreturn]] void fail(const std::string& message) const
+        {
+            throw std::runtime_error(filename + ", line " + std::to_string(line) + ": " + message);
+        }
+
+        template<typename T>
+        T next(const char* what)
+        {
+            skipSpaces();
+            T value;
+            auto [position, error] = std::from_chars(current, end, value);
+            if (error != std::errc() || (position < end && !std::isspace((unsigned char) *position)))
+                fail(std::string("expected ") + what);
+            current = position;
+            return value;
+        }
+
+        // Whether another number follows on the same line
+        bool numberOnLine()
+        {
+            while (current < end && (*current == ' ' || *current == '\t' || *current == '\r'))
+                ++current;
+            return current < end && std::isdigit((unsigned char) *current);
+        }
+
+        bool atEnd()
+        {
+            skipSpaces();
+            return current == end;
+        }
+
+        bool atNumber()
+        {
+            skipSpaces();
+            return current < end && (std::isdigit((unsigned char) *current) || *current == '-' || *current == '.');
+        }
+
+        // The rest of the current line, without surrounding spaces
+        std::string restOfLine()
+        {
+            skipSpaces();
+            const char* begin = current;
+            while (current < end && *current != '\n')
+                ++current;
+            const char* last = current;
+            while (last > begin && std::isspace((unsigned char) last[-1]))
+                --last;
+            return std::string(begin, last);
+        }
+
+        template<typename T>
+        T parse(const std::string& text, const char* what) const
+        {
+            T value;
+            auto [position, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+            if (error != std::errc() || position != text.data() + text.size())
+                fail(std::string("expected ") + what);
+            return value;
+        }
+};
+
+// TSPLIB files start with a keyword, the native format with a number
+bool isTsplib(const std::string& filename)
+{
+    MappedFile file(filename);
+    for (size_t k = 0; k < file.size(); k++)
+        if (!std::isspace((unsigned char) file.data()[k]))
+            return std::isalpha((unsigned char) file.data()[k]);
+    return false;
+}
+
+}
+
+namespace instance
+{
+
+Instance readText(const std::string& filename, bool verbose)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    MappedFile file(filename);
+    Tokenizer tokens(filename, file.data(), file.data() + file.size());
+    Instance instance;
+
+    instance.N = tokens.next<int>("the number of vertices");
+    instance.V = tokens.next<int>("the number of vehicles");
+    instance.C = tokens.next<double>("the capacity");
+    if (tokens.numberOnLine())
+    {
+        instance.procedural_factors = true;
+        instance.carbon_seed = tokens.next<uint64_t>("the carbon seed");
+    }
+    if (instance.N < 2 || instance.V < 1 || !(instance.C > 0.0) || std::isinf(instance.C))
+        tokens.fail("invalid header, expected N >= 2, V >= 1 and C > 0");
+
+    int N = instance.N;
+    instance.points.resize(N);
+    for (int i = 0; i < N; i++)
+    {
+        Point& p = instance.points[i];
+        p.d = tokens.next<double>("a demand");
+        p.x = tokens.next<double>("an x coordinate");
+        p.y = tokens.next<double>("a y coordinate");
+        if (!std::isfinite(p.x) || !std::isfinite(p.y))
+            tokens.fail("coordinates must be finite");
+        if (!(p.d >= 0.0) || p.d > instance.C)
+            tokens.fail("demands must be between 0 and the capacity");
+    }
+
+    if (!instance.procedural_factors)
+    {
+        instance.carbon_factors = TriMatrix<double>(N);
+        double* factor = instance.carbon_factors.data();
+        for (size_t k = 0; k < instance.carbon_factors.size(); k++)
+        {
+            factor[k] = tokens.next<double>("a carbon factor");
+            if (!(factor[k] >= 0.0) || std::isinf(factor[k]))
+                tokens.fail("carbon factors must be finite and non-negative");
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (verbose)
+        printf("Parsed %s: %.2lf MB in %.3lf s (%.1lf MB/s)\n", filename.c_str(), file.size() / 1e6, seconds, file.size() / 1e6 / std::max(seconds, 1e-9));
+    return instance;
+}
+
+Instance readTsplib(const std::string& filename, bool verbose)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    MappedFile file(filename);
+    Tokenizer tokens(filename, file.data(), file.data() + file.size());
+
+    int N = 0, V = 0, depot = -1;
+    double C = 0.0;
+    int64_t carbon_seed = -1;
+    std::string weight_type = "EUC_2D", weight_format = "FULL_MATRIX";
+    std::vector<double> x, y, demands, weights;
+    std::vector<bool> has_coordinates, has_demand;
+
+    auto vertex = [&](const char* what) {
+        int id = tokens.next<int>(what);
+        if (id < 1 || id > N)
+            tokens.fail("vertex out of range");
+        return id - 1;
+    };
+
+    while (!tokens.atEnd())
+    {
+        std::string line = tokens.restOfLine();
+        size_t colon = line.find(':');
+        std::string key = line.substr(0, std::min(colon, line.find_first_of(" \t")));
+        std::string value = colon == std::string::npos ? "" : line.substr(colon + 1);
+        value.erase(0, std::min(value.size(), value.find_first_not_of(" \t")));
+
+        if (key == "EOF")
+            break;
+        else if (key == "TYPE" && value != "CVRP")
+            tokens.fail("only CVRP instances are supported");
+        else if (key == "DIMENSION")
+        {
+            N = tokens.parse<int>(value, "the dimension");
+            if (N < 2)
+                tokens.fail("the dimension must be at least 2");
+            x.assign(N, 0.0);
+            y.assign(N, 0.0);
+            demands.assign(N, 0.0);
+            has_coordinates.assign(N, false);
+            has_demand.assign(N, false);
+        }
+        else if (key == "CAPACITY")
+            C = tokens.parse<double>(value, "the capacity");
+        else if (key == "CARBON_SEED")
+            carbon_seed = tokens.parse<uint64_t>(value, "the carbon seed");
+        else if (key == "VEHICLES")
+            V = tokens.parse<int>(value, "the number of vehicles");
+        else if (key == "EDGE_WEIGHT_TYPE")
+            weight_type = value;
+        else if (key == "EDGE_WEIGHT_FORMAT")
+            weight_format = value;
+        else if (key.size() > 8 && key.compare(key.size() - 8, 8, "_SECTION") == 0 && N == 0)
+            tokens.fail("DIMENSION must come before the sections");
+        else if (key == "NODE_COORD_SECTION")
+            for (int k = 0; k < N; k++)
+            {
+                int i = vertex("a vertex");
+                x[i] = tokens.next<double>("an x coordinate");
+                y[i] = tokens.next<double>("a y coordinate");
+                has_coordinates[i] = true;
+            }
+        else if (key == "DEMAND_SECTION")
+            for (int k = 0; k < N; k++)
+            {
+                int i = vertex("a vertex");
+                demands[i] = tokens.next<double>("a demand");
+                has_demand[i] = true;
+            }
+        else if (key == "DEPOT_SECTION")
+        {
+            depot = vertex("the depot");
+            if (tokens.next<int>("-1 closing the depot section") != -1)
+                tokens.fail("only a single depot is supported");
+        }
+        else if (key == "EDGE_WEIGHT_SECTION")
+        {
+            size_t count;
+            if (weight_format == "FULL_MATRIX")
+                count = (size_t) N * N;
+            else if (weight_format == "LOWER_ROW")
+                count = TriMatrix<double>::count(N);
+            else if (weight_format == "LOWER_DIAG_ROW")
+                count = TriMatrix<double>::count(N) + N;
+            else
+                tokens.fail("unsupported EDGE_WEIGHT_FORMAT " + weight_format);
+
+            weights.resize(count);
+            for (auto& w : weights)
+                w = tokens.next<double>("an edge weight");
+        }
+        else if (key.size() > 8 && key.compare(key.size() - 8, 8, "_SECTION") == 0)
+            // Sections the solver has no use for, like DISPLAY_DATA_SECTION
+            while (tokens.atNumber())
+                tokens.next<double>("a number");
+    }
+
+    if (N == 0 || !(C > 0.0) || std::isinf(C))
+        tokens.fail("missing DIMENSION or CAPACITY");
+    for (int i = 0; i < N; i++)
+        if (!has_demand[i] || !(demands[i] >= 0.0) || demands[i] > C)
+            tokens.fail("every vertex needs a demand between 0 and the capacity");
+
+    // The depot is the one listed, or the first vertex, and is moved to position 0
+    if (depot < 0)
+        depot = 0;
+    std::vector<int> order = { depot };
+    for (int i = 0; i < N; i++)
+        if (i != depot)
+            order.push_back(i);
+
+    Instance instance;
+    instance.N = N;
+    instance.V = V > 0 ? V : N - 1;
+    instance.C = C;
+    instance.points.resize(N);
+    for (int k = 0; k < N; k++)
+        instance.points[k] = { x[order[k]], y[order[k]], k == 0 ? 0.0 : demands[order[k]] };
+
+    instance.edge_weights = TriMatrix<double>(N);
+    if (weight_type == "EXPLICIT")
+    {
+        if (weights.empty())
+            tokens.fail("EXPLICIT edge weights without an EDGE_WEIGHT_SECTION");
+
+        auto weight = [&](int i, int j) {
+            if (i < j)
+                std::swap(i, j);
+            if (weight_format == "FULL_MATRIX")
+                return weights[(size_t) i * N + j];
+            if (weight_format == "LOWER_ROW")
+                return weights[TriMatrix<double>::index(i, j)];
+            return weights[TriMatrix<double>::index(i, j) + i];     // row i is preceded by i diagonal entries
+        };
+        for (int a = 1; a < N; a++)
+            for (int b = 0; b < a; b++)
+                instance.edge_weights(a, b) = weight(order[a], order[b]);
+    }
+    else if (weight_type == "EUC_2D" || weight_type == "CEIL_2D")
+    {
+        for (int i = 0; i < N; i++)
+            if (!has_coordinates[i])
+                tokens.fail("every vertex needs coordinates");
+
+        // TSPLIB distances are integers: rounded to the nearest one for EUC_2D, rounded up for CEIL_2D
+        bool ceiling = weight_type == "CEIL_2D";
+        for (int a = 1; a < N; a++)
+            for (int b = 0; b < a; b++)
+            {
+                double d = std::hypot(instance.points[a].x - instance.points[b].x, instance.points[a].y - instance.points[b].y);
+                instance.edge_weights(a, b) = ceiling ? std::ceil(d) : std::floor(d + 0.5);
+            }
+    }
+    else
+        tokens.fail("unsupported EDGE_WEIGHT_TYPE " + weight_type);
+
+    if (carbon_seed >= 0)
+    {
+        instance.procedural_factors = true;
+        instance.carbon_seed = carbon_seed;
+    }
+    else
+        instance.carbon_factors = TriMatrix<double>(N, 1.0);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (verbose)
+        printf("Parsed %s: %.2lf MB in %.3lf s (%.1lf MB/s)\n", filename.c_str(), file.size() / 1e6, seconds, file.size() / 1e6 / std::max(seconds, 1e-9));
+    return instance;
+}
+
+Instance readBinary(const std::string& filename, bool verbose)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    auto file = std::make_shared<MappedFile>(filename);
+    BinaryHeader header;
+    if (!readHeader(*file, header))
+    {
+        throw std::runtime_error(filename + " is not a valid binary instance");
+    }
+
+    Instance instance;
+    instance.N = header.N;
+    instance.V = header.V;
+    instance.C = header.C;
+
+    const char* points = file->data() + sizeof(BinaryHeader);
+    instance.points.resize(header.N);
+    memcpy(instance.points.data(), points, header.N * sizeof(Point));
+
+    const char* factors = points + header.N * sizeof(Point);
+    if (header.edge_weights)
+    {
+        instance.edge_weights = TriMatrix<double>::view(header.N, reinterpret_cast<const double*>(factors));
+        factors += TriMatrix<double>::count(header.N) * sizeof(double);
+    }
+    instance.procedural_factors = header.procedural_factors;
+    instance.carbon_seed = header.carbon_seed;
+    if (!instance.procedural_factors && header.factor_size == sizeof(double))
+        instance.carbon_factors = TriMatrix<double>::view(header.N, reinterpret_cast<const double*>(factors));
+    else if (!instance.procedural_factors)
+        instance.carbon_factors_single = TriMatrix<float>::view(header.N, reinterpret_cast<const float*>(factors));
+    instance.mapping = file;
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (verbose)
+        printf("Loaded %s: %.2lf MB in %.3lf s\n", filename.c_str(), file->size() / 1e6, seconds);
+    return instance;
+}
+
+bool writeBinary(const std::string& filename, const Instance& instance, bool single_precision)
+{
+    return writeFile(filename, instance, single_precision, 0, 0);
+}
+
+Instance load(const std::string& filename, bool use_cache, bool single_precision, bool verbose)
+{
+    if (filename.size() > 5 && filename.compare(filename.size() - 5, 5, ".vrpb") == 0)
+        return readBinary(filename, verbose);
+    if (!use_cache)
+        return isTsplib(filename) ? readTsplib(filename, verbose) : readText(filename, verbose);
+
+    std::string cache = filename + ".vrpb";
+    int64_t source_size, source_mtime;
+    if (!fileStamp(filename, source_size, source_mtime))
+        throw std::runtime_error("couldn't open file " + filename);
+
+    // An up to date cache has the text file's size and modification time
+    struct stat info;
+    if (stat(cache.c_str(), &info) == 0)
+    {
+        MappedFile file(cache);
+        BinaryHeader header;
+        if (readHeader(file, header) && header.source_size == source_size && header.source_mtime == source_mtime
+            && header.factor_size == (single_precision ? sizeof(float) : sizeof(double)))
+            return readBinary(cache, verbose);
+    }
+
+    // Read back from the new cache, so the factors have the same precision on every run
+    Instance instance = isTsplib(filename) ? readTsplib(filename, verbose) : readText(filename, verbose);
+    if (!writeFile(cache, instance, single_precision, source_size, source_mtime))
+    {
+        printf("Warning: couldn't write the binary cache %s\n", cache.c_str());
+        return instance;
+    }
+    return readBinary(cache, verbose);
+}
+
+}
\ No newline at end of file
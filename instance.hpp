@@ -0,0 +1,71 @@
+#ifndef INSTANCE_HPP
+#define INSTANCE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mappedfile.hpp"
+#include "philox.hpp"
+#include "trimatrix.hpp"
+
+struct Point 
+{
+    double x;
+    double y;
+    double d;
+};
+
+// N vertices (the depot is vertex 0), V vehicles of capacity C, and the carbon factor of every edge.
+// The factors are in one of the two matrices, which are views into the mapping when read from a binary file.
+// Instances with a carbon seed have no stored factors, they are generated on demand instead.
+// Edge weights are only given by instances whose distances aren't Euclidean between the points.
+struct Instance
+{
+    int N, V;
+    double C;
+    std::vector<Point> points;
+    TriMatrix<double> edge_weights;
+    TriMatrix<double> carbon_factors;
+    TriMatrix<float> carbon_factors_single;
+    std::shared_ptr<MappedFile> mapping;
+    bool procedural_factors = false;
+    uint64_t carbon_seed = 0;
+
+    double carbonFactor(unsigned int i, unsigned int j) const
+    {
+        if (procedural_factors)
+            return philox::carbonFactor(carbon_seed, i, j);
+        return carbon_factors.dimension() > 0 ? carbon_factors(i, j) : carbon_factors_single(i, j);
+    }
+};
+
+namespace instance
+{
+
+// Text format: "N V C", then "demand x y" for each vertex, then the carbon factor triangle row by row
+// ((1,0), (2,0), (2,1), ...). With "N V C seed" the triangle is left out and the factors are generated from the seed.
+// Anything after the triangle, like the best known value, is ignored.
+// Throws std::runtime_error with the offending line on malformed input.
+// The readers print the size and the time taken unless verbose is false.
+Instance readText(const std::string& filename, bool verbose = true);
+
+// TSPLIB/CVRPLIB format (the CVRPLIB X, A, B, ... sets): a single depot, EUC_2D, CEIL_2D or EXPLICIT edge weights
+// (FULL_MATRIX, LOWER_ROW or LOWER_DIAG_ROW), and carbon factors of 1.0 as the format has none, unless a
+// CARBON_SEED keyword asks for generated ones. The depot becomes
+// vertex 0, and the number of vehicles is VEHICLES if given, N - 1 otherwise.
+Instance readTsplib(const std::string& filename, bool verbose = true);
+
+// Binary format (.vrpb, native byte order): a fixed header, the vertices, then the carbon factor triangle
+// as doubles or floats, laid out so that it can be used in place from a memory map
+Instance readBinary(const std::string& filename, bool verbose = true);
+bool writeBinary(const std::string& filename, const Instance& instance, bool single_precision);
+
+// Reads .vrpb files directly. Text instances, in either format, go through the binary cache <filename>.vrpb, written on the first
+// load and rebuilt whenever the text file or the requested precision changes.
+Instance load(const std::string& filename, bool use_cache, bool single_precision, bool verbose = true);
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,284 @@
+#include "localsearch.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+
+const double EPS = 1e-7;
+
+}
+
+localsearch::LocalSearch::LocalSearch(const TriMatrix<double>& distances, const TriMatrix<double>& carbon_costs, const double* demands, int N, double C, int granularity, unsigned int seed):
+    N(N), C(C), demands(demands), distances(distances), carbon_costs(carbon_costs), costs(N), granularity(std::min(granularity, N - 2)), neighbours(N), generator(seed), route_of(N, -1), position_of(N, -1)
+{
+    setWeights(1.0, 0.0);
+}
+localsearch::LocalSearch::~LocalSearch() {}
+
+void localsearch::LocalSearch::setWeights(double w1, double w2)
+{
+    for (size_t e = 0; e < costs.size(); e++)
+        costs.data()[e] = w1 * distances.data()[e] + w2 * carbon_costs.data()[e];
+
+    // Granular neighbour lists under the new costs
+    std::vector<int> candidates;
+    for (int u = 1; u < N; u++)
+    {
+        candidates.clear();
+        for (int v = 1; v < N; v++)
+            if (v != u)
+                candidates.push_back(v);
+
+        std::partial_sort(candidates.begin(), candidates.begin() + granularity, candidates.end(),
+            [&](int a, int b) { return costs(u, a) < costs(u, b); });
+        neighbours[u].assign(candidates.begin(), candidates.begin() + granularity);
+    }
+}
+
+double localsearch::LocalSearch::cost(const Routes& solution) const
+{
+    return routes::cost(solution, costs);
+}
+
+void localsearch::LocalSearch::loadSolution(const Routes& solution)
+{
+    tours.clear();
+    prefix_load.clear();
+    std::fill(route_of.begin(), route_of.end(), -1);
+    std::fill(position_of.begin(), position_of.end(), -1);
+    for (auto& route : solution)
+    {
+        if (route.empty())
+            continue;
+
+        std::vector<int> tour;
+        tour.reserve(route.size() + 2);
+        tour.push_back(0);
+        tour.insert(tour.end(), route.begin(), route.end());
+        tour.push_back(0);
+
+        tours.push_back(tour);
+        prefix_load.emplace_back();
+        updateRoute(tours.size() - 1);
+    }
+}
+
+void localsearch::LocalSearch::updateRoute(int r)
+{
+    auto& tour = tours[r];
+    prefix_load[r].resize(tour.size());
+
+    prefix_load[r][0] = 0.0;
+    for (unsigned int k = 1; k < tour.size(); k++)
+    {
+        prefix_load[r][k] = prefix_load[r][k - 1] + demands[tour[k]];
+        route_of[tour[k]] = r;
+        position_of[tour[k]] = k;
+    }
+}
+
+// Moves tours[r1][p1 .. p1+length-1] between positions t and t+1 of route r2, in either orientation
+bool localsearch::LocalSearch::moveSegment(int r1, int p1, int length, int r2, int t)
+{
+    auto& from = tours[r1];
+    auto& to = tours[r2];
+    int p2 = p1 + length - 1;
+
+    if (p2 >= (int) from.size() - 1 || t >= (int) to.size() - 1)
+        return false;
+    if (r1 == r2 && t >= p1 - 1 && t <= p2)
+        return false;
+
+    double segment_load = prefix_load[r1][p2] - prefix_load[r1][p1 - 1];
+    if (r1 != r2 && load(r2) + segment_load > C + EPS)
+        return false;
+
+    int a = from[p1 - 1], s = from[p1], e = from[p2], b = from[p2 + 1];
+    int x = to[t], y = to[t + 1];
+
+    double removal = cost(a, b) - cost(a, s) - cost(e, b);
+    double forward = removal + cost(x, s) + cost(e, y) - cost(x, y);
+    double reversed = removal + cost(x, e) + cost(s, y) - cost(x, y);
+    if (std::min(forward, reversed) > -EPS)
+        return false;
+
+    std::vector<int> segment(from.begin() + p1, from.begin() + p2 + 1);
+    if (reversed < forward)
+        std::reverse(segment.begin(), segment.end());
+
+    from.erase(from.begin() + p1, from.begin() + p2 + 1);
+    if (r1 == r2 && t > p2)
+        t -= length;
+    to.insert(to.begin() + t + 1, segment.begin(), segment.end());
+
+    updateRoute(r1);
+    if (r1 != r2)
+        updateRoute(r2);
+    return true;
+}
+
+bool localsearch::LocalSearch::swap(int u, int v)
+{
+    int ru = route_of[u], rv = route_of[v];
+    int pu = position_of[u], pv = position_of[v];
+
+    if (ru != rv)
+    {
+        if (load(ru) - demands[u] + demands[v] > C + EPS || load(rv) - demands[v] + demands[u] > C + EPS)
+            return false;
+    }
+    else if (pu > pv)
+    {
+        std::swap(u, v);
+        std::swap(pu, pv);
+    }
+
+    auto& tu = tours[ru];
+    auto& tv = tours[rv];
+    int a = tu[pu - 1], b = tu[pu + 1], c = tv[pv - 1], d = tv[pv + 1];
+
+    double delta;
+    if (ru == rv && pv == pu + 1)
+        delta = cost(a, v) + cost(u, d) - cost(a, u) - cost(v, d);
+    else
+        delta = cost(a, v) + cost(v, b) - cost(a, u) - cost(u, b)
+              + cost(c, u) + cost(u, d) - cost(c, v) - cost(v, d);
+    if (delta > -EPS)
+        return false;
+
+    tu[pu] = v;
+    tv[pv] = u;
+    updateRoute(ru);
+    if (ru != rv)
+        updateRoute(rv);
+    return true;
+}
+
+// Reverses tours[r][p+1 .. q], replacing edges (p, p+1) and (q, q+1) by (p, q) and (p+1, q+1)
+bool localsearch::LocalSearch::twoOpt(int r, int p, int q)
+{
+    auto& tour = tours[r];
+    if (p > q)
+        std::swap(p, q);
+    if (p < 0 || q >= (int) tour.size() - 1 || q <= p + 1)
+        return false;
+
+    double delta = cost(tour[p], tour[q]) + cost(tour[p + 1], tour[q + 1]) - cost(tour[p], tour[p + 1]) - cost(tour[q], tour[q + 1]);
+    if (delta > -EPS)
+        return false;
+
+    std::reverse(tour.begin() + p + 1, tour.begin() + q + 1);
+    updateRoute(r);
+    return true;
+}
+
+// Exchanges the tails after positions p1 and p2: (u, nu), (v, nv) become (u, nv), (v, nu)
+bool localsearch::LocalSearch::twoOptStar(int r1, int p1, int r2, int p2)
+{
+    auto& t1 = tours[r1];
+    auto& t2 = tours[r2];
+    if (r1 == r2 || p1 >= (int) t1.size() - 1 || p2 >= (int) t2.size() - 1)
+        return false;
+
+    if (prefix_load[r1][p1] + load(r2) - prefix_load[r2][p2] > C + EPS ||
+        prefix_load[r2][p2] + load(r1) - prefix_load[r1][p1] > C + EPS)
+        return false;
+
+    double delta = cost(t1[p1], t2[p2 + 1]) + cost(t2[p2], t1[p1 + 1]) - cost(t1[p1], t1[p1 + 1]) - cost(t2[p2], t2[p2 + 1]);
+    if (delta > -EPS)
+        return false;
+
+    std::vector<int> tail1(t1.begin() + p1 + 1, t1.end());
+    t1.erase(t1.begin() + p1 + 1, t1.end());
+    t1.insert(t1.end(), t2.begin() + p2 + 1, t2.end());
+    t2.erase(t2.begin() + p2 + 1, t2.end());
+    t2.insert(t2.end(), tail1.begin(), tail1.end());
+
+    updateRoute(r1);
+    updateRoute(r2);
+    return true;
+}
+
+// Joins the heads and the tails: (u, nu), (v, nv) become (u, v), (nu, nv)
+bool localsearch::LocalSearch::twoOptStarReversed(int r1, int p1, int r2, int p2)
+{
+    auto& t1 = tours[r1];
+    auto& t2 = tours[r2];
+    if (r1 == r2 || p1 >= (int) t1.size() - 1 || p2 >= (int) t2.size() - 1)
+        return false;
+
+    if (prefix_load[r1][p1] + prefix_load[r2][p2] > C + EPS ||
+        load(r1) - prefix_load[r1][p1] + load(r2) - prefix_load[r2][p2] > C + EPS)
+        return false;
+
+    double delta = cost(t1[p1], t2[p2]) + cost(t1[p1 + 1], t2[p2 + 1]) - cost(t1[p1], t1[p1 + 1]) - cost(t2[p2], t2[p2 + 1]);
+    if (delta > -EPS)
+        return false;
+
+    std::vector<int> head(t1.begin(), t1.begin() + p1 + 1);
+    head.insert(head.end(), t2.rend() - p2 - 1, t2.rend());
+    std::vector<int> tail(t1.rbegin(), t1.rend() - p1 - 1);
+    tail.insert(tail.end(), t2.begin() + p2 + 1, t2.end());
+
+    t1 = head;
+    t2 = tail;
+    updateRoute(r1);
+    updateRoute(r2);
+    return true;
+}
+
+bool localsearch::LocalSearch::improveClient(int u)
+{
+    for (int v : neighbours[u])
+    {
+        if (route_of[v] < 0)
+            continue;
+
+        int ru = route_of[u], rv = route_of[v];
+        int pu = position_of[u], pv = position_of[v];
+
+        // Relocate and or-opt: u and its successors after v, or before v
+        for (int length = 1; length <= 3; length++)
+            if (moveSegment(ru, pu, length, rv, pv) || moveSegment(ru, pu, length, rv, pv - 1))
+                return true;
+
+        if (swap(u, v))
+            return true;
+
+        if (ru == rv)
+        {
+            if (twoOpt(ru, pu, pv) || twoOpt(ru, pu - 1, pv - 1))
+                return true;
+        }
+        else if (twoOptStar(ru, pu, rv, pv - 1) || twoOptStarReversed(ru, pu, rv, pv))
+            return true;
+    }
+
+    return false;
+}
+
+Routes localsearch::LocalSearch::improve(const Routes& solution)
+{
+    loadSolution(solution);
+
+    std::vector<int> order(N - 1);
+    std::iota(order.begin(), order.end(), 1);
+
+    bool improved = true;
+    while (improved)
+    {
+        improved = false;
+        std::shuffle(order.begin(), order.end(), generator);
+        for (int u : order)
+            while (route_of[u] >= 0 && improveClient(u))
+                improved = true;
+    }
+
+    Routes result;
+    for (auto& tour : tours)
+        if (tour.size() > 2)
+            result.emplace_back(tour.begin() + 1, tour.end() - 1);
+    return result;
+}
\ No newline at end of file
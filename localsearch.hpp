@@ -0,0 +1,64 @@
+#ifndef LOCALSEARCH_HPP
+#define LOCALSEARCH_HPP
+
+#include <random>
+#include <vector>
+
+#include "routes.hpp"
+#include "trimatrix.hpp"
+
+namespace localsearch
+{
+
+// First improvement local search with relocate/or-opt, swap, 2-opt and 2-opt* moves.
+// Moves are only tried between a client and its closest neighbours (granular neighbourhood),
+// and every move is evaluated in O(1): costs are symmetric, so only the edges it replaces matter,
+// and capacity is checked against the per-route prefix loads.
+// Edge costs are w1 * distance + w2 * carbon-weighted distance.
+class LocalSearch
+{
+    private:
+        int N;
+        double C;
+        const double* demands;
+        const TriMatrix<double>& distances;
+        const TriMatrix<double>& carbon_costs;
+        TriMatrix<double> costs;
+        int granularity;
+        std::vector<std::vector<int>> neighbours;
+        std::default_random_engine generator;
+
+        // Routes with the depot at both ends, prefix_load[r][k] covers tours[r][0..k]
+        std::vector<std::vector<int>> tours;
+        std::vector<std::vector<double>> prefix_load;
+        std::vector<int> route_of;
+        std::vector<int> position_of;
+
+        double load(int r) const { return prefix_load[r].back(); }
+
+        void loadSolution(const Routes& solution);
+        void updateRoute(int r);
+
+        bool moveSegment(int r1, int p1, int length, int r2, int t);
+        bool swap(int u, int v);
+        bool twoOpt(int r, int p, int q);
+        bool twoOptStar(int r1, int p1, int r2, int p2);
+        bool twoOptStarReversed(int r1, int p1, int r2, int p2);
+        bool improveClient(int u);
+
+    public:
+        LocalSearch(const TriMatrix<double>& distances, const TriMatrix<double>& carbon_costs, const double* demands, int N, double C, int granularity, unsigned int seed);
+        ~LocalSearch();
+
+        void setWeights(double w1, double w2);
+        double cost(int i, int j) const { return i == j ? 0.0 : costs(i, j); }
+        double cost(const Routes& solution) const;
+        const TriMatrix<double>& weightedCosts() const { return costs; }
+        const std::vector<int>& closest(int u) const { return neighbours[u]; }
+        // Clients the solution leaves out are neither moved nor inserted
+        Routes improve(const Routes& solution);
+};
+
+}
+
+#endif
\ No newline at end of file
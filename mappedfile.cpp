@@ -0,0 +1,40 @@
+#include "mappedfile.hpp"
+
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string& filename): begin(nullptr), length(0)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0)
+    {
+        if (fd >= 0)
+            close(fd);
+        throw std::runtime_error("couldn't open file " + filename);
+    }
+
+    length = info.st_size;
+    if (length > 0)
+    {
+        void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED)
+        {
+            close(fd);
+            throw std::runtime_error("couldn't map file " + filename);
+        }
+        begin = static_cast<const char*>(address);
+        madvise(address, length, MADV_SEQUENTIAL);
+    }
+    close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (begin != nullptr)
+        munmap(const_cast<char*>(begin), length);
+}
\ No newline at end of file
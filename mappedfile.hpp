@@ -0,0 +1,26 @@
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory map of a whole file
+class MappedFile
+{
+    private:
+        const char* begin;
+        size_t length;
+
+    public:
+        // Throws std::runtime_error if the file can't be opened
+        MappedFile(const std::string& filename);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const char* data() const { return begin; }
+        size_t size() const { return length; }
+};
+
+#endif
\ No newline at end of file
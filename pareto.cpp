@@ -0,0 +1,169 @@
+#include "pareto.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace
+{
+
+const double EPS = 1e-6;
+
+}
+
+ParetoArchive::ParetoArchive():
+    ref1(std::numeric_limits<double>::infinity()), ref2(std::numeric_limits<double>::infinity()), volume(0.0) {}
+
+double ParetoArchive::slice(std::map<double, ParetoPoint>::const_iterator it) const
+{
+    if (std::isinf(ref1) || std::isinf(ref2))
+        return 0.0;
+
+    auto next = std::next(it);
+    double right = next == front.end() ? ref1 : std::min(next->second.distance, ref1);
+    double width = right - std::min(it->second.distance, ref1);
+    return std::max(0.0, width) * std::max(0.0, ref2 - it->second.carbon);
+}
+
+bool ParetoArchive::insert(const ParetoPoint& point)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    // Among the points with no larger distance, the last one has the smallest carbon
+    auto after = front.upper_bound(point.distance + EPS);
+    if (after != front.begin() && std::prev(after)->second.carbon <= point.carbon + EPS)
+        return false;
+
+    // The points it dominates come right after it, up to the first one with less carbon
+    auto first = front.lower_bound(point.distance - EPS);
+    auto last = first;
+    while (last != front.end() && last->second.carbon >= point.carbon - EPS)
+        ++last;
+
+    auto previous = first == front.begin() ? front.end() : std::prev(first);
+    if (previous != front.end())
+        volume -= slice(previous);
+    for (auto it = first; it != last; ++it)
+        volume -= slice(it);
+
+    front.erase(first, last);
+    auto position = front.emplace_hint(last, point.distance, point);
+
+    volume += slice(position);
+    if (previous != front.end())
+        volume += slice(previous);
+
+    if (listener)
+        listener(point);
+    return true;
+}
+
+void ParetoArchive::setListener(std::function<void(const ParetoPoint&)> listener)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    this->listener = listener;
+}
+
+std::vector<ParetoPoint> ParetoArchive::points() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    std::vector<ParetoPoint> result;
+    result.reserve(front.size());
+    for (auto& entry : front)
+        result.push_back(entry.second);
+    return result;
+}
+
+bool ParetoArchive::best(double w1, double w2, ParetoPoint& point, double max_carbon) const
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    const ParetoPoint* best_point = nullptr;
+    for (auto& entry : front)
+    {
+        const ParetoPoint& p = entry.second;
+        if (p.carbon <= max_carbon && (best_point == nullptr || w1 * p.distance + w2 * p.carbon < w1 * best_point->distance + w2 * best_point->carbon))
+            best_point = &p;
+    }
+
+    if (best_point == nullptr)
+        return false;
+    point = *best_point;
+    return true;
+}
+
+size_t ParetoArchive::size() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return front.size();
+}
+
+void ParetoArchive::setReference(double distance, double carbon)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    ref1 = distance;
+    ref2 = carbon;
+    volume = 0.0;
+    for (auto it = front.begin(); it != front.end(); ++it)
+        volume += slice(it);
+}
+
+double ParetoArchive::hypervolume() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return volume;
+}
+
+double ParetoArchive::spacing() const
+{
+    std::vector<ParetoPoint> S = points();
+    if (S.size() < 3)
+        return 0.0;
+
+    // The staircase is sorted by distance ascending and carbon descending, so the gaps of both objectives
+    // come from the same consecutive pairs
+    double DM = 0.0;
+    for (int h = 0; h < 2; h++)
+    {
+        std::vector<double> gaps;
+        for (size_t i = 0; i + 1 < S.size(); i++)
+            gaps.push_back(h == 0 ? S[i + 1].distance - S[i].distance : S[i].carbon - S[i + 1].carbon);
+
+        double mean = 0.0, sd = 0.0;
+        for (double d : gaps)
+            mean += d;
+        mean /= gaps.size();
+        for (double d : gaps)
+            sd += (d - mean) * (d - mean);
+        sd = std::sqrt(sd / (gaps.size() - 1));
+
+        if (mean > 0.0)
+            DM += sd / mean;
+    }
+
+    return DM / S.size();
+}
+
+std::vector<double> ParetoArchive::crowding() const
+{
+    std::vector<ParetoPoint> S = points();
+    size_t n = S.size();
+    std::vector<double> distance(n, 0.0);
+    if (n == 0)
+        return distance;
+
+    double range1 = S[n - 1].distance - S[0].distance;
+    double range2 = S[0].carbon - S[n - 1].carbon;
+    for (size_t j = 1; j + 1 < n; j++)
+    {
+        if (range1 > 0.0)
+            distance[j] += (S[j + 1].distance - S[j - 1].distance) / range1;
+        if (range2 > 0.0)
+            distance[j] += (S[j - 1].carbon - S[j + 1].carbon) / range2;
+    }
+
+    distance[0] = distance[n - 1] = std::numeric_limits<double>::infinity();
+    return distance;
+}
\ No newline at end of file
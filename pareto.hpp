@@ -0,0 +1,59 @@
+#ifndef PARETO_HPP
+#define PARETO_HPP
+
+#include <functional>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "routes.hpp"
+
+struct ParetoPoint
+{
+    double distance, carbon;
+    Routes routes;
+};
+
+// Non-dominated points found so far, kept as a staircase keyed by distance (carbon decreases along it),
+// so insertions and dominance checks take O(log n). Safe to share between threads.
+class ParetoArchive
+{
+    private:
+        mutable std::mutex lock;
+        std::map<double, ParetoPoint> front;
+        double ref1, ref2;
+        double volume;
+        std::function<void(const ParetoPoint&)> listener;
+
+        // Area between the point, the next one and the reference point
+        double slice(std::map<double, ParetoPoint>::const_iterator it) const;
+
+    public:
+        ParetoArchive();
+
+        // Returns false if the point is dominated by (or equal to) an archived one
+        bool insert(const ParetoPoint& point);
+
+        // Called with every point accepted from now on, in insertion order, while the archive is locked
+        void setListener(std::function<void(const ParetoPoint&)> listener);
+        std::vector<ParetoPoint> points() const;
+
+        // Archived point minimizing w1 * distance + w2 * carbon among those with carbon <= max_carbon,
+        // false if there is none
+        bool best(double w1, double w2, ParetoPoint& point, double max_carbon = std::numeric_limits<double>::infinity()) const;
+        size_t size() const;
+
+        // Hypervolume dominated by the archive and bounded by the reference point, kept up to date on every insertion
+        void setReference(double distance, double carbon);
+        double hypervolume() const;
+
+        // Spacing metric of utils/metric.py: coefficient of variation of the gaps between consecutive points
+        // along each objective, summed over both and divided by the number of points
+        double spacing() const;
+
+        // Crowding distance of each point, in the order of points(), as in utils/crowding.py
+        std::vector<double> crowding() const;
+};
+
+#endif
\ No newline at end of file
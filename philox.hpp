@@ -0,0 +1,44 @@
+#ifndef PHILOX_HPP
+#define PHILOX_HPP
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3"):
+// every counter gives an independent block of random bits, so values can be computed in any order
+namespace philox
+{
+
+typedef std::array<uint32_t, 4> Counter;
+typedef std::array<uint32_t, 2> Key;
+
+inline Counter generate(Counter counter, Key key)
+{
+    const uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+    const uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+
+    for (int round = 0; round < 10; round++)
+    {
+        uint64_t product0 = (uint64_t) M0 * counter[0];
+        uint64_t product1 = (uint64_t) M1 * counter[2];
+        counter = { (uint32_t) (product1 >> 32) ^ counter[1] ^ key[0], (uint32_t) product1,
+                    (uint32_t) (product0 >> 32) ^ counter[3] ^ key[1], (uint32_t) product0 };
+        key[0] += W0;
+        key[1] += W1;
+    }
+    return counter;
+}
+
+// Carbon factor of edge (i, j) for an instance seed, uniform in [0.5, 2.0] like utils/carbon_adder.py
+inline double carbonFactor(uint64_t seed, uint32_t i, uint32_t j)
+{
+    if (i < j)
+        std::swap(i, j);
+    Counter bits = generate({ i, j, 0, 0 }, { (uint32_t) seed, (uint32_t) (seed >> 32) });
+    return 0.5 + 1.5 * (bits[0] * (1.0 / 4294967296.0));
+}
+
+}
+
+#endif
\ No newline at end of file
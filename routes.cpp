@@ -0,0 +1,95 @@
+#include "routes.hpp"
+
+double routes::cost(const Routes& solution, const TriMatrix<double>& costs)
+{
+    double total = 0.0;
+    for (auto& route : solution)
+    {
+        if (route.empty())
+            continue;
+        total += costs(0, route.front()) + costs(route.back(), 0);
+        for (unsigned int k = 1; k < route.size(); k++)
+            total += costs(route[k - 1], route[k]);
+    }
+    return total;
+}
+
+TriMatrix<double> routes::toEdgeValues(const Routes& solution, unsigned int N)
+{
+    TriMatrix<double> vals(N, 0.0);
+    for (auto& route : solution)
+    {
+        if (route.empty())
+            continue;
+        vals(0, route.front()) += 1.0;
+        vals(route.back(), 0) += 1.0;
+        for (unsigned int k = 1; k < route.size(); k++)
+            vals(route[k - 1], route[k]) += 1.0;
+    }
+    return vals;
+}
+
+Routes routes::fromEdgeValues(const TriMatrix<double>& vals)
+{
+    int N = vals.dimension();
+    std::vector<std::vector<int>> adjacent(N);
+    for (int i = 1; i < N; i++)
+        for (int j = 0; j < i; j++)
+            if (vals(i, j) > 0.5)
+            {
+                adjacent[i].push_back(j);
+                adjacent[j].push_back(i);
+                if (j == 0 && vals(i, j) > 1.5)
+                    adjacent[i].push_back(0);
+            }
+
+    Routes solution;
+    std::vector<bool> seen(N, false);
+    for (int start : adjacent[0])
+    {
+        if (seen[start])
+            continue;
+
+        std::vector<int> route;
+        int previous = 0, current = start;
+        while (current != 0 && !seen[current])
+        {
+            route.push_back(current);
+            seen[current] = true;
+
+            int next = 0;
+            for (int v : adjacent[current])
+                if (v != previous && (v == 0 || !seen[v]))
+                {
+                    next = v;
+                    break;
+                }
+            previous = current;
+            current = next;
+        }
+        solution.push_back(route);
+    }
+
+    return solution;
+}
+
+bool routes::isFeasible(const Routes& solution, const double* demands, int N, double C)
+{
+    std::vector<bool> seen(N, false);
+    int visited = 0;
+    for (auto& route : solution)
+    {
+        double load = 0.0;
+        for (int i : route)
+        {
+            if (i <= 0 || i >= N || seen[i])
+                return false;
+            seen[i] = true;
+            load += demands[i];
+            ++visited;
+        }
+        if (load > C + 1e-9)
+            return false;
+    }
+    return visited == N - 1;
+}
\ No newline at end of file
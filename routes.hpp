@@ -0,0 +1,26 @@
+#ifndef ROUTES_HPP
+#define ROUTES_HPP
+
+#include <vector>
+
+#include "trimatrix.hpp"
+
+// Each route lists its clients in visiting order, the depot (vertex 0) is implicit at both ends
+typedef std::vector<std::vector<int>> Routes;
+
+namespace routes
+{
+
+double cost(const Routes& solution, const TriMatrix<double>& costs);
+
+// Edge usage x_e of a solution, a single client route uses its depot edge twice
+TriMatrix<double> toEdgeValues(const Routes& solution, unsigned int N);
+
+// Routes through the depot in an integer edge solution, client cycles that skip the depot are left out
+Routes fromEdgeValues(const TriMatrix<double>& vals);
+
+bool isFeasible(const Routes& solution, const double* demands, int N, double C);
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include "savings.hpp"
+
+#include <algorithm>
+#include <queue>
+
+savings::RouteMerger::RouteMerger(int N, const double* demands, double C):
+    N(N), C(C), demands(demands), components(N), load(demands, demands + N), degree(N, 0), neighbours(N), num_routes(N - 1)
+{
+    for (auto& adjacent : neighbours)
+        adjacent.reserve(2);
+}
+savings::RouteMerger::~RouteMerger() {}
+
+bool savings::RouteMerger::tryMerge(int i, int j)
+{
+    if (i == j || i == 0 || j == 0 || degree[i] > 1 || degree[j] > 1)
+        return false;
+
+    unsigned int ri = components.find(i);
+    unsigned int rj = components.find(j);
+    if (ri == rj || load[ri] + load[rj] > C + 1e-9)
+        return false;
+
+    double merged_load = load[ri] + load[rj];
+    components.unite(ri, rj);
+    load[components.find(i)] = merged_load;
+
+    neighbours[i].push_back(j);
+    neighbours[j].push_back(i);
+    ++degree[i];
+    ++degree[j];
+    --num_routes;
+
+    return true;
+}
+
+int savings::RouteMerger::routeCount() const
+{
+    return num_routes;
+}
+
+Routes savings::RouteMerger::routes() const
+{
+    Routes solution;
+    solution.reserve(num_routes);
+    std::vector<bool> seen(N, false);
+
+    // Every route has at least one client with degree < 2 to start from
+    for (int start = 1; start < N; start++)
+    {
+        if (seen[start] || degree[start] > 1)
+            continue;
+
+        std::vector<int> route;
+        int previous = 0, current = start;
+        while (current != 0)
+        {
+            route.push_back(current);
+            seen[current] = true;
+
+            int next = 0;
+            for (int v : neighbours[current])
+                if (v != previous)
+                    next = v;
+            previous = current;
+            current = next;
+        }
+        solution.push_back(route);
+    }
+
+    return solution;
+}
+
+namespace
+{
+
+struct saving
+{
+    double value;
+    int i, j;
+
+    bool operator<(const saving& other) const { return value < other.value; }
+};
+
+void mergeBySavings(savings::RouteMerger& merger, const TriMatrix<double>& costs, int N)
+{
+    std::vector<saving> list;
+    list.reserve(costs.size());
+    for (int i = 2; i < N; i++)
+        for (int j = 1; j < i; j++)
+        {
+            double s = costs(0, i) + costs(0, j) - costs(i, j);
+            if (s > 0.0)
+                list.push_back({ s, i, j });
+        }
+
+    std::priority_queue<saving> heap(std::less<saving>(), std::move(list));
+    while (!heap.empty() && merger.routeCount() > 1)
+    {
+        saving s = heap.top();
+        heap.pop();
+        merger.tryMerge(s.i, s.j);
+    }
+}
+
+}
+
+Routes savings::clarkeWright(const TriMatrix<double>& costs, const double* demands, int N, double C)
+{
+    RouteMerger merger(N, demands, C);
+    mergeBySavings(merger, costs, N);
+    return merger.routes();
+}
+
+Routes savings::roundRelaxation(const TriMatrix<double>& relaxation, const TriMatrix<double>& costs, const double* demands, int N, double C, double min_value)
+{
+    std::vector<saving> edges;
+    for (int i = 2; i < N; i++)
+        for (int j = 1; j < i; j++)
+            if (relaxation(i, j) > min_value)
+                edges.push_back({ relaxation(i, j), i, j });
+
+    std::sort(edges.begin(), edges.end(), [](const saving& a, const saving& b) { return b < a; });
+
+    RouteMerger merger(N, demands, C);
+    for (auto& e : edges)
+        merger.tryMerge(e.i, e.j);
+    mergeBySavings(merger, costs, N);
+
+    return merger.routes();
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#ifndef SAVINGS_HPP
+#define SAVINGS_HPP
+
+#include <vector>
+
+#include "routes.hpp"
+#include "trimatrix.hpp"
+#include "unionfind.hpp"
+
+namespace savings
+{
+
+// Joins routes end to end while respecting the vehicle capacity.
+// Starts with one route per client, routes are identified by their union-find root.
+class RouteMerger
+{
+    private:
+        int N;
+        double C;
+        const double* demands;
+        UnionFind components;
+        std::vector<double> load;
+        std::vector<int> degree;
+        std::vector<std::vector<int>> neighbours;
+        int num_routes;
+
+    public:
+        RouteMerger(int N, const double* demands, double C);
+        ~RouteMerger();
+
+        // Links clients i and j if both are route ends of different routes that fit together in a vehicle
+        bool tryMerge(int i, int j);
+        int routeCount() const;
+        Routes routes() const;
+};
+
+// Parallel Clarke-Wright savings heuristic
+Routes clarkeWright(const TriMatrix<double>& costs, const double* demands, int N, double C);
+
+// Rounds a fractional edge solution: client-client edges are joined in decreasing order of their value
+// (those above min_value), then the remaining route fragments are merged by savings
+Routes roundRelaxation(const TriMatrix<double>& relaxation, const TriMatrix<double>& costs, const double* demands, int N, double C, double min_value);
+
+}
+
+#endif
\ No newline at end of file
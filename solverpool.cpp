@@ -0,0 +1,61 @@
+#include "solverpool.hpp"
+
+#include <atomic>
+#include <exception>
+#include <thread>
+
+SolverPool::SolverPool(const Problem& problem, const SolverOptions& options, int size, CutPool& cut_pool, const std::vector<GRBEnv*>& envs)
+{
+    for (int k = 0; k < size; k++)
+        models.push_back(new CVRPModel(problem, options, cut_pool, *envs[k]));
+}
+
+SolverPool::~SolverPool()
+{
+    for (CVRPModel* model : models)
+        delete model;
+}
+
+int SolverPool::size() const
+{
+    return models.size();
+}
+
+std::vector<SolveResult> SolverPool::solveAll(const std::vector<SolveJob>& jobs, ParetoArchive& archive)
+{
+    std::vector<SolveResult> results(jobs.size());
+    std::vector<std::exception_ptr> errors(models.size());
+    std::atomic<size_t> next_job(0);
+
+    auto work = [&](int k) {
+        try
+        {
+            size_t i;
+            while ((i = next_job++) < jobs.size())
+            {
+                results[i] = models[k]->solve(jobs[i].scalarization, jobs[i].starts, &archive);
+                if (results[i].feasible)
+                    archive.insert({ results[i].distance, results[i].carbon, results[i].routes });
+            }
+        }
+        catch (...)
+        {
+            errors[k] = std::current_exception();
+        }
+    };
+
+    // The calling thread works with the first replica
+    int num_threads = std::min<int>(models.size(), jobs.size());
+    std::vector<std::thread> threads;
+    for (int k = 1; k < num_threads; k++)
+        threads.emplace_back(work, k);
+    work(0);
+    for (auto& t : threads)
+        t.join();
+
+    for (auto& e : errors)
+        if (e)
+            std::rethrow_exception(e);
+
+    return results;
+}
\ No newline at end of file
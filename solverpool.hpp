@@ -0,0 +1,34 @@
+#ifndef SOLVERPOOL_HPP
+#define SOLVERPOOL_HPP
+
+#include <vector>
+
+#include "gurobi_c++.h"
+#include "cvrpmodel.hpp"
+#include "pareto.hpp"
+
+struct SolveJob
+{
+    Scalarization scalarization;
+    std::vector<Routes> starts;
+};
+
+// Replicas of the model, each in its own Gurobi environment, that solve independent scalarizations in parallel
+class SolverPool
+{
+    private:
+        std::vector<CVRPModel*> models;
+
+    public:
+        // Every replica shares the cut pool, replica k is built in envs[k]
+        SolverPool(const Problem& problem, const SolverOptions& options, int size, CutPool& cut_pool, const std::vector<GRBEnv*>& envs);
+        ~SolverPool();
+
+        int size() const;
+
+        // Solves every job, handing them out to the replicas as they become free. Results come in the
+        // same order as the jobs and every feasible one is also inserted into the archive.
+        std::vector<SolveResult> solveAll(const std::vector<SolveJob>& jobs, ParetoArchive& archive);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,54 @@
+#ifndef SPSCQUEUE_HPP
+#define SPSCQUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+// One slot is kept empty to tell a full queue from an empty one.
+template <typename T>
+class SPSCQueue
+{
+    private:
+        std::vector<T> slots;
+        alignas(64) std::atomic<size_t> head;   // next slot to read, owned by the consumer
+        alignas(64) std::atomic<size_t> tail;   // next slot to write, owned by the producer
+
+        size_t next(size_t i) const { return i + 1 == slots.size() ? 0 : i + 1; }
+
+    public:
+        SPSCQueue(size_t capacity): slots(capacity + 1), head(0), tail(0) {}
+
+        // Producer side, returns false if the queue is full
+        bool push(T&& value)
+        {
+            size_t t = tail.load(std::memory_order_relaxed);
+            size_t n = next(t);
+            if (n == head.load(std::memory_order_acquire))
+                return false;
+
+            slots[t] = std::move(value);
+            tail.store(n, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side, returns false if the queue is empty
+        bool pop(T& value)
+        {
+            size_t h = head.load(std::memory_order_relaxed);
+            if (h == tail.load(std::memory_order_acquire))
+                return false;
+
+            value = std::move(slots[h]);
+            head.store(next(h), std::memory_order_release);
+            return true;
+        }
+
+        bool empty() const
+        {
+            return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+        }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,66 @@
+#ifndef TRIMATRIX_HPP
+#define TRIMATRIX_HPP
+
+#include <algorithm>
+#include <vector>
+
+// Strictly lower triangular n x n matrix stored row by row, (1,0), (2,0), (2,1), ...
+// This is the same order in which the x[i][j] variables are created, so index(i, j)
+// doubles as the variable's position in the model.
+// A view reads values kept elsewhere, like a memory-mapped file, which must outlive it.
+template <typename T>
+class TriMatrix
+{
+    private:
+        std::vector<T> values;
+        T* base;
+        unsigned int n;
+        bool owner;
+
+    public:
+        TriMatrix(): base(nullptr), n(0), owner(true) {}
+        TriMatrix(unsigned int n, T value = T()): values(count(n), value), base(values.data()), n(n), owner(true) {}
+        TriMatrix(const TriMatrix& other): values(other.values), base(other.owner ? values.data() : other.base), n(other.n), owner(other.owner) {}
+        TriMatrix(TriMatrix&& other) noexcept: values(std::move(other.values)), base(other.owner ? values.data() : other.base), n(other.n), owner(other.owner) {}
+
+        TriMatrix& operator=(TriMatrix other)
+        {
+            values.swap(other.values);
+            base = other.owner ? values.data() : other.base;
+            n = other.n;
+            owner = other.owner;
+            return *this;
+        }
+
+        // Read only, writing through a view of a read-only mapping faults
+        static TriMatrix view(unsigned int n, const T* data)
+        {
+            TriMatrix matrix;
+            matrix.base = const_cast<T*>(data);
+            matrix.n = n;
+            matrix.owner = false;
+            return matrix;
+        }
+
+        static size_t count(unsigned int n) { return n > 1 ? (size_t) n * (n - 1) / 2 : 0; }
+
+        static size_t index(unsigned int i, unsigned int j)
+        {
+            if (i < j)
+                std::swap(i, j);
+            return (size_t) i * (i - 1) / 2 + j;
+        }
+
+        // Symmetric access, i != j
+        T operator()(unsigned int i, unsigned int j) const { return base[index(i, j)]; }
+        T& operator()(unsigned int i, unsigned int j) { return base[index(i, j)]; }
+
+        unsigned int dimension() const { return n; }
+        size_t size() const { return count(n); }
+        const T* data() const { return base; }
+        T* data() { return base; }
+
+        void fill(T value) { std::fill(base, base + size(), value); }
+};
+
+#endif
\ No newline at end of file
@@ -1,218 +1,149 @@
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <sstream>
 #include <cstdio>
+#include <cstring>
+#include <cerrno>
 #include <cmath>
 #include <random>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include <list>
 #include <limits>
-#include <queue>
 #include <chrono>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <csignal>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 #include "gurobi_c++.h"
-#include "karger.hpp"
+#include "binpacking.hpp"
+#include "cutpool.hpp"
+#include "cvrpmodel.hpp"
+#include "frontdriver.hpp"
+#include "frontstream.hpp"
+#include "instance.hpp"
+#include "pareto.hpp"
+#include "routes.hpp"
+#include "savings.hpp"
+#include "solverpool.hpp"
+#include "trimatrix.hpp"
 #include "cxxopts/cxxopts.hpp"
 
-struct Point 
+// Outcome of one run, a row of the batch table or the answer to a daemon request
+struct RunSummary
+{
+    std::string status;
+    int N = 0, min_K = 0;
+    size_t points = 0;
+    double hypervolume = 0.0, spacing = 0.0;
+    double min_distance = 0.0, min_carbon = 0.0;
+    double seconds = 0.0;
+    std::vector<ParetoPoint> front;
+    std::vector<double> crowding;
+};
+
+// A solution read from the .heu file and the numbers written before its routes
+struct HeuristicSolution
 {
-    double x;
-    double y;
-    double d;
+    std::vector<double> header;
+    Routes routes;
 };
 
 double dist(const Point& a, const Point& b);
 
-std::vector<Point> getPointsFromFile(std::string filename, int *V, double *C, double**& carbon_factors);
-double** getHeuristicSol(std::string filename, int N, int V, double* upper_bound);
-void writeSolution(GRBVar** x, int N, int V, const double obj, const int opt, const std::string& filename);
+cxxopts::Options makeOptions();
+std::string validateOptions(const cxxopts::ParseResult& command_line, bool csv_required);
+cxxopts::ParseResult* parseLine(cxxopts::Options& options, const std::string& line, std::string& error);
+RunSummary solveInstance(const cxxopts::ParseResult& command_line, std::vector<GRBEnv*>& envs, int concurrent_runs);
+int runBatch(cxxopts::Options& options, const cxxopts::ParseResult& command_line);
+int runDaemon(cxxopts::Options& options, const cxxopts::ParseResult& command_line);
+void serveRequests(cxxopts::Options& options, FILE* in, FILE* out, std::vector<GRBEnv*>& envs);
+std::string csvField(const std::string& text);
 
-class subtourelim: public GRBCallback
+std::vector<HeuristicSolution> getHeuristicSols(std::string filename);
+
+int main(int argc, char *argv[])
 {
-    public:
-        GRBVar** x;
-        int N, V;
-        double C, coefficient;
-        double* demands;
-        int* spanning_cover_constraints;
-        bool use_log;
-        int min_K;
-        karger::EdgeVector cut_generator;
-        subtourelim(GRBVar** x, double* demands, int N, int V, double C, double coefficient, bool use_log, int* spanning_cover_constraints):
-            x(x), N(N), V(V), C(C), demands(demands), cut_generator(N, std::chrono::system_clock::now().time_since_epoch().count()), coefficient(coefficient), use_log(use_log), spanning_cover_constraints(spanning_cover_constraints) {
-                double total_demand = 0.0;
-                for (int i = 0; i < N; i++)
-                    total_demand += demands[i];
-
-                min_K = std::ceil(total_demand / C);
-            };
-
-        ~subtourelim() {}
-        
-
-    protected:
-        void callback()
-        {
-            if (where == GRB_CB_MIPSOL)
-            {
-                std::vector<bool> seen;
-                for (int i = 0; i < N; i++)
-                    seen.push_back(false);
-                int start, current = 0;
-                double route_demand;
-                bool found_way;
-                
-                // Sweeping through depot routes
-                do {
-                    start = 0;
-                    for (int i = 1; i < N; i++)
-                        if (!seen[i] && getSolution(x[i][0]) > 0.5)
-                        {
-                            start = i;
-                            break;
-                        }
-
-                    if (start != 0)
-                    {
-                        std::list<int> tour;
-                        tour.push_back(start);
-                        route_demand = demands[start];
-                        found_way = false;
-                        current = start;
-                        seen[start] = true;
-
-                        do {
-                            found_way = false;
-                            for (int j = 1; j < N; j++)
-                                {
-                                    if (current != j && !seen[j] && getSolution(x[std::max(current, j)][std::min(current, j)]) > 0.5)
-                                    {
-                                        found_way = true;
-                                        tour.push_back(j);
-                                        current = j;
-                                        seen[j] = true;
-                                        route_demand += demands[j];
-                                        break;
-                                    }
-                                }
-                        } while(found_way);
-
-                        // if the route exceeds capacity
-                        if (route_demand > C)
-                        {
-                            GRBLinExpr c = 0.0;
-                            double ub = std::ceil(route_demand / C);
-                            for (auto i = tour.begin(); i != tour.end(); ++i)
-                                for (auto j = std::next(i); j != tour.end(); ++j)
-                                    c += x[std::max(*i,*j)][std::min(*i,*j)];
-
-                            addLazy(c, GRB_LESS_EQUAL, tour.size() - ub);
-                        }
-                    }
-                    
-                } while (start != 0);
-
-                // Sweeping through non-depot routes
-                for (start = 1; start < N; start++)
-                {
-                    if (!seen[start])
-                    {
-                        std::list<int> tour;
-                        tour.push_back(start);
-                        route_demand = demands[start];
-                        seen[start] = true;
-                        current = start;
-
-                        do {
-                            found_way = false;
-                            for (int j = 1; j < N; j++)
-                                {
-                                    if (current != j && !seen[j] && getSolution(x[std::max(current, j)][std::min(current, j)]) > 0.5)
-                                    {
-                                        found_way = true;
-                                        tour.push_back(j);
-                                        current = j;
-                                        seen[j] = true;
-                                        route_demand += demands[j];
-                                        break;
-                                    }
-                                }
-                        } while (found_way);
-
-                        GRBLinExpr c = 0.0;
-                        double ub = std::ceil(route_demand / C);
-                        for (auto i = tour.begin(); i != tour.end(); ++i)
-                            for (auto j = std::next(i); j != tour.end(); ++j)
-                                c += x[std::max(*i,*j)][std::min(*i,*j)];
-
-                        addLazy(c, GRB_LESS_EQUAL, tour.size() - ub);
-                    }
-                } 
+    cxxopts::Options options = makeOptions();
+    auto command_line = options.parse(argc, argv);
 
-            }
-            else if (where == GRB_CB_MIPNODE && getIntInfo(GRB_CB_MIPNODE_STATUS) == GRB_OPTIMAL)
-            {
-                std::vector<double> sum_of_demands;
-
-                // Karger Setup
-                for (int i = 1; i < N; i++)
-                    for (int j = 1; j < i; j++)
-                        cut_generator.add_edge(i, j, getNodeRel(x[i][j]));
-
-                // Run Karger 
-                for (int count = 0; count < coefficient * (use_log ? std::log(N) : N); count++)
-                {
-                    sum_of_demands.clear();
-                    auto cuts = cut_generator.randomCut(demands, sum_of_demands, min_K);
-
-                    // Going through each cut
-                    for (int cut_i = 0; cut_i < cuts.size(); ++cut_i)
-                    {
-                        double sum_demands = sum_of_demands[cut_i];
-                        double r = std::ceil(sum_demands / C);
-                        double current_cut_value = 0.0;
-                        GRBLinExpr c = 0.0;
-
-                        for (auto i = cuts[cut_i].begin(); i != cuts[cut_i].end(); ++i)
-                            for (auto j = std::next(i); j != cuts[cut_i].end(); ++j)
-                            {
-                                c += x[std::max(*i,*j)][std::min(*i,*j)];
-                                current_cut_value += getNodeRel(x[std::max(*i,*j)][std::min(*i,*j)]);
-                            }
-
-                        if (current_cut_value > cuts[cut_i].size() - r)
-                            addLazy(c, GRB_LESS_EQUAL, cuts[cut_i].size() - r);
-                    }
-                }
-
-                cut_generator.clear_edges();
-            }
-        }
-};
+    if (command_line.count("help"))
+    {
+        std::cout << options.help() << std::endl;
+        exit(0);
+    }
 
-struct weights
-{
-    double w1, w2;
-    int layer;
-};
+    if (command_line.count("batch"))
+        return runBatch(options, command_line);
 
-int main(int argc, char *argv[])
-{
-    int V, N, MAX_WEIGHTS_LAYERS;
-    double C, time_limit, upper_bound = std::numeric_limits<double>::infinity();
-    double coefficient;
-    double **carbon_factors = nullptr;
-    bool use_log, use_heur, use_tcheby, normalize, use_nadir;
-    std::vector<Point> clients;
-    std::string csv_filename;
-    double **heur_vals = nullptr;
+    if (command_line["daemon"].as<bool>())
+        return runDaemon(options, command_line);
 
+    if (!command_line.count("file") || !command_line.count("csv-output"))
+    {
+        std::cout << options.help() << std::endl;
+        exit(1);
+    }
+
+    std::string error = validateOptions(command_line, true);
+    if (!error.empty())
+    {
+        std::cout << "Error: " << error << std::endl;
+        exit(1);
+    }
+
+    std::vector<GRBEnv*> envs;
+    RunSummary summary = {};
+    try
+    {
+        summary = solveInstance(command_line, envs, 1);
+    } 
+    catch (GRBException e) 
+    {
+        std::cout << "Error code = " << e.getErrorCode() << std::endl;
+        std::cout << e.getMessage() << std::endl;
+    } 
+    catch (const std::exception& e)
+    {
+        std::cout << "Error: " << e.what() << std::endl;
+    }
+    catch (...) 
+    {
+        std::cout << "Unknown error" << std::endl;
+    }
+
+    for (GRBEnv* env : envs)
+        delete env;
+
+    return summary.status == "ok" ? 0 : 1;
+}
+
+cxxopts::Options makeOptions()
+{
     cxxopts::Options options("CVRPSolver", "Outputs an exact solution for a CVRP instance");
     options.add_options()
         ("f,file", "Input file name", cxxopts::value<std::string>())
+        ("no-cache", "Always parse the text instance instead of going through its binary cache <file>.vrpb", cxxopts::value<bool>()->default_value("false"))
+        ("carbon-seed", "Generate the carbon factors from this seed instead of reading them from the instance", cxxopts::value<uint64_t>())
+        ("single-precision-factors", "Keep the carbon factors as floats in the binary cache", cxxopts::value<bool>()->default_value("false"))
         ("o,csv-output", "CSV output file name", cxxopts::value<std::string>())
-        ("H,use-heuristic", "Use a heuristic solution from <input-file-name>.heu", cxxopts::value<bool>()->default_value("false"))
+        ("A,archive-output", "CSV output file for every non-dominated point found, including incumbents and pool solutions", cxxopts::value<std::string>())
+        ("checkpoint", "File where the state of the front computation is saved after every batch of scalarizations", cxxopts::value<std::string>())
+        ("resume", "Continue the front computation saved in the checkpoint file", cxxopts::value<bool>()->default_value("false"))
+        ("time-budget", "Wall-clock budget in seconds for the whole front, divided among the scalarizations (0 for none)", cxxopts::value<double>()->default_value("0"))
+        ("endpoint-share", "Fraction of the time budget given to the two single-objective solves", cxxopts::value<double>()->default_value("0.5"))
+        ("stream-output", "Writes each non-dominated point as soon as it is found to <base>.csv, its routes to <base>.routes and their offsets to <base>.idx", cxxopts::value<std::string>())
+        ("pool-solutions", "Number of solutions Gurobi keeps in its pool for each solve", cxxopts::value<int>()->default_value("10"))
+        ("H,use-heuristic", "Use the heuristic solutions of <input-file-name>.heu as MIP starts", cxxopts::value<bool>()->default_value("false"))
+        ("heuristic-starts", "Number of .heu solutions given to each scalarization as MIP starts, the best ones under its weights", cxxopts::value<int>()->default_value("3"))
         ("C,karger-coefficient", "Constant coefficient for how many times Karger's Algorithm will be executed", cxxopts::value<double>()->default_value("10.0"))
         ("l,use-log-n", "Run Karger's Algorithm O(log n) times instead of O(n)", cxxopts::value<bool>()->default_value("false"))
         ("t,time-limit", "Time limit for the solver in seconds", cxxopts::value<double>()->default_value("3600.0"))
@@ -220,27 +151,117 @@ int main(int argc, char *argv[])
         ("N,normalization", "Normalize objectives", cxxopts::value<bool>()->default_value("false"))
         ("y,nadir", "Use nadir points for normalization", cxxopts::value<bool>()->default_value("false"))
         ("L,weight-layers", "Depth of the weight recursion", cxxopts::value<int>()->default_value("2"))
+        ("W,weights", "How weights are chosen: layers (fixed-depth bisection) or nise (adaptive, weighted sum only)", cxxopts::value<std::string>()->default_value("layers"))
+        ("nise-tolerance", "Stop refining a segment once the front is proven this close to it (objectives normalized by their ranges)", cxxopts::value<double>()->default_value("0.001"))
+        ("nise-priority", "Segment solved next with adaptive weights: error or hypervolume (largest possible gain)", cxxopts::value<std::string>()->default_value("error"))
+        ("E,epsilon-constraint", "Generate the front with the epsilon-constraint method instead of weights", cxxopts::value<bool>()->default_value("false"))
+        ("epsilon-step", "Gap between the emissions of a point and the next epsilon, relative to the emissions range", cxxopts::value<double>()->default_value("0.00001"))
+        ("nise-max-solves", "Maximum number of scalarizations with adaptive weights, 0 for no limit", cxxopts::value<int>()->default_value("0"))
+        ("w,heuristic-thread", "Run an iterated local search in a background thread and feed its solutions to the solver", cxxopts::value<bool>()->default_value("false"))
+        ("r,rounding-frequency", "Run the LP rounding heuristic on every n-th node relaxation (0 disables it)", cxxopts::value<int>()->default_value("10"))
+        ("R,rounding-time-share", "Maximum fraction of the solver's runtime spent in the LP rounding heuristic", cxxopts::value<double>()->default_value("0.05"))
+        ("g,ls-granularity", "Number of closest neighbours considered by the local search moves", cxxopts::value<int>()->default_value("20"))
+        ("j,parallel-models", "Number of model replicas solving independent scalarizations in parallel", cxxopts::value<int>()->default_value("1"))
+        ("threads-per-model", "Gurobi threads for each model replica, 0 splits the machine's cores evenly", cxxopts::value<int>()->default_value("0"))
+        ("e,bpp-exact-limit", "Solve the bin packing bound exactly for client sets up to this size", cxxopts::value<int>()->default_value("20"))
+        ("batch", "Manifest with the options of one run per line, solved in this process", cxxopts::value<std::string>())
+        ("batch-workers", "Number of runs of the batch solved at the same time", cxxopts::value<int>()->default_value("1"))
+        ("batch-output", "CSV table with a row for each run of the batch", cxxopts::value<std::string>()->default_value("batch_results.csv"))
+        ("daemon", "Keeps running and solves the requests read from stdin or the socket, one line of options each")
+        ("socket", "Unix socket where the daemon accepts requests instead of stdin", cxxopts::value<std::string>())
         ("h,help", "Prints this page")
     ;
+    return options;
+}
 
-    auto command_line = options.parse(argc, argv);
+// Checks that can be made before loading anything, empty if the options are fine
+std::string validateOptions(const cxxopts::ParseResult& command_line, bool csv_required)
+{
+    if (!command_line.count("file"))
+        return "the input file is required";
+    if (csv_required && !command_line.count("csv-output"))
+        return "the CSV output file is required";
 
-    try 
-    {
+    std::ifstream f(command_line["file"].as<std::string>());
+    if (!f.is_open())
+        return "couldn't open file " + command_line["file"].as<std::string>();
 
-    if (command_line.count("help"))
+    std::string weights = command_line["weights"].as<std::string>();
+    if (weights != "layers" && weights != "nise")
+        return "--weights must be layers or nise, not " + weights;
+    std::string priority = command_line["nise-priority"].as<std::string>();
+    if (priority != "error" && priority != "hypervolume")
+        return "--nise-priority must be error or hypervolume, not " + priority;
+
+    if (weights == "nise" && command_line["infinite-metric"].as<bool>())
+        return "adaptive weights need the weighted sum, not the Tchebycheff metric";
+
+    if (command_line["resume"].as<bool>() && !command_line.count("checkpoint"))
+        return "--resume needs the --checkpoint file";
+
+    return "";
+}
+
+// Options of a run of the batch or the daemon, written as on the command line. Null, with the reason in error, if they are invalid.
+cxxopts::ParseResult* parseLine(cxxopts::Options& options, const std::string& line, std::string& error)
+{
+    std::istringstream tokens(line);
+    std::vector<std::string> words = { "CVRPSolver" };
+    std::string word;
+    while (tokens >> word)
+        words.push_back(word);
+
+    std::vector<char*> argv;
+    for (std::string& w : words)
+        argv.push_back(&w[0]);
+    int argc = argv.size();
+    char** args = argv.data();
+
+    cxxopts::ParseResult* run = nullptr;
+    try
     {
-        std::cout << options.help() << std::endl;
-        exit(0);
+        run = new cxxopts::ParseResult(options.parse(argc, args));
+    }
+    catch (const cxxopts::OptionException& e)
+    {
+        error = e.what();
+        return nullptr;
     }
 
-    if (!command_line.count("file") || !command_line.count("csv-output"))
+    if (run->count("batch") || (*run)["daemon"].as<bool>() || run->count("help"))
+        error = "--batch, --daemon and --help can only be given on the command line";
+    else
+        error = validateOptions(*run, false);
+
+    if (!error.empty())
     {
-        std::cout << options.help() << std::endl;
-        exit(1);
+        delete run;
+        return nullptr;
     }
+    return run;
+}
+
+// Computes the front of one instance. The Gurobi environments are created as needed and kept by the caller,
+// and when runs share the machine its cores are split among all of their model replicas.
+RunSummary solveInstance(const cxxopts::ParseResult& command_line, std::vector<GRBEnv*>& envs, int concurrent_runs)
+{
+    auto start = std::chrono::steady_clock::now();
 
-    csv_filename = command_line["csv-output"].as<std::string>();
+    int V, N, MAX_WEIGHTS_LAYERS, bpp_exact_limit, granularity, rounding_frequency, num_models, threads_per_model;
+    double C, time_limit;
+    double rounding_time_share;
+    double coefficient;
+    Instance instance;
+    bool use_log, use_heur, use_tcheby, normalize, use_nadir, use_worker;
+    FrontOptions front_options;
+    std::vector<Point> clients;
+    std::string csv_filename;
+    std::vector<HeuristicSolution> heuristic_solutions;
+    RunSummary summary = {};
+    summary.status = "ok";
+
+    if (command_line.count("csv-output"))
+        csv_filename = command_line["csv-output"].as<std::string>();
     coefficient = command_line["karger-coefficient"].as<double>();
     use_log = command_line["use-log-n"].as<bool>();
     use_heur = command_line["use-heuristic"].as<bool>();
@@ -249,343 +270,515 @@ int main(int argc, char *argv[])
     normalize = command_line["normalization"].as<bool>();
     time_limit = command_line["time-limit"].as<double>();
     MAX_WEIGHTS_LAYERS = command_line["weight-layers"].as<int>();
-
-    clients = getPointsFromFile(command_line["file"].as<std::string>(), &V, &C, carbon_factors);
-    N = clients.size();
+    bpp_exact_limit = command_line["bpp-exact-limit"].as<int>();
+    granularity = command_line["ls-granularity"].as<int>();
+    use_worker = command_line["heuristic-thread"].as<bool>();
+    rounding_frequency = command_line["rounding-frequency"].as<int>();
+    rounding_time_share = command_line["rounding-time-share"].as<double>();
+    num_models = std::max(1, command_line["parallel-models"].as<int>());
+    threads_per_model = command_line["threads-per-model"].as<int>();
+
+    front_options.tcheby = use_tcheby;
+    front_options.normalize = normalize;
+    front_options.use_nadir = use_nadir;
+    front_options.max_layers = MAX_WEIGHTS_LAYERS;
+    front_options.nise = command_line["weights"].as<std::string>() == "nise";
+    front_options.nise_tolerance = command_line["nise-tolerance"].as<double>();
+    front_options.hypervolume_priority = command_line["nise-priority"].as<std::string>() == "hypervolume";
+    front_options.max_solves = command_line["nise-max-solves"].as<int>();
+    front_options.epsilon = command_line["epsilon-constraint"].as<bool>();
+    front_options.epsilon_step = command_line["epsilon-step"].as<double>();
+    front_options.time_budget = command_line["time-budget"].as<double>();
+    front_options.endpoint_share = command_line["endpoint-share"].as<double>();
+
+    instance = instance::load(command_line["file"].as<std::string>(), !command_line["no-cache"].as<bool>(), command_line["single-precision-factors"].as<bool>());
+    N = instance.N;
+    V = instance.V;
+    C = instance.C;
+    clients = instance.points;
+    if (command_line.count("carbon-seed"))
+    {
+        instance.procedural_factors = true;
+        instance.carbon_seed = command_line["carbon-seed"].as<uint64_t>();
+    }
+    if (instance.procedural_factors)
+        printf("Carbon factors generated from seed %lu\n", (unsigned long) instance.carbon_seed);
 
     if (use_heur)
-        heur_vals = getHeuristicSol(command_line["file"].as<std::string>(), N, V, &upper_bound);
-    }
-    catch(cxxopts::OptionException* e) {
-        std::cout << options.help() << std::endl;
-        exit(1);
+        heuristic_solutions = getHeuristicSols(command_line["file"].as<std::string>());
+
+    double total_demands = 0.0;
+    std::vector<double> client_demands;
+    for (int i = 1; i < N; i++)
+    {
+        total_demands += clients[i].d;
+        client_demands.push_back(clients[i].d);
     }
 
+    int min_K = binpacking::minBins(client_demands, C, bpp_exact_limit);
+    V = std::max(min_K, std::min<int>(V, std::ceil((2*total_demands) / C)));
+    printf("Minimum fleet size: %d (continuous bound %d)\n", min_K, binpacking::lowerBoundL1(client_demands, C));
+
+    std::vector<double> demands(N);
+    for (int i = 0; i < N; i++)
+        demands[i] = clients[i].d;
+
+    TriMatrix<double> distances(N), carbon_costs(N);
+    for (int i = 1; i < N; i++)
+        for (int j = 0; j < i; j++)
+        {
+            distances(i, j) = instance.edge_weights.dimension() > 0 ? instance.edge_weights(i, j) : dist(clients[i], clients[j]);
+            carbon_costs(i, j) = instance.carbonFactor(i, j) * distances(i, j);
+        }
+
+    // Starting solutions for the endpoint solves: savings on each objective. The .heu solutions are handed to
+    // the driver, which adds the best ones for each scalarization.
+    Routes distance_start = savings::clarkeWright(distances, demands.data(), N, C);
+    Routes carbon_start = savings::clarkeWright(carbon_costs, demands.data(), N, C);
+
+    printf("Initial solutions: distance %lf (%zu routes), carbon emissions %lf (%zu routes)\n",
+        routes::cost(distance_start, distances), distance_start.size(), routes::cost(carbon_start, carbon_costs), carbon_start.size());
+
+    std::vector<ParetoPoint> heuristic_starts;
+    for (size_t k = 0; k < heuristic_solutions.size(); k++)
+    {
+        const HeuristicSolution& h = heuristic_solutions[k];
+        if (!routes::isFeasible(h.routes, demands.data(), N, C))
+        {
+            printf("Warning: heuristic solution %zu isn't a feasible solution of this instance, skipped\n", k + 1);
+            continue;
+        }
+
+        ParetoPoint point = { routes::cost(h.routes, distances), routes::cost(h.routes, carbon_costs), h.routes };
+        if (h.header.size() == 2 && (std::abs(h.header[0] - point.distance) > 1e-3 * std::max(1.0, point.distance)
+            || std::abs(h.header[1] - point.carbon) > 1e-3 * std::max(1.0, point.carbon)))
+            printf("Warning: heuristic solution %zu has distance %lf and carbon emissions %lf, not the ones in its header\n",
+                k + 1, point.distance, point.carbon);
+        heuristic_starts.push_back(point);
+    }
+    if (use_heur)
+        printf("Heuristic solutions: %zu of %zu usable as MIP starts\n", heuristic_starts.size(), heuristic_solutions.size());
+
+    // Model replicas, the machine's cores are split evenly among the replicas of all concurrent runs unless told otherwise
+    if (threads_per_model <= 0 && num_models * concurrent_runs > 1)
+        threads_per_model = std::max<int>(1, std::thread::hardware_concurrency() / (num_models * concurrent_runs));
+    if (use_worker)
+        threads_per_model = std::max<int>(1, (threads_per_model > 0 ? threads_per_model : std::thread::hardware_concurrency()) - 1);
+
+    Problem problem = { N, V, min_K, C, demands.data(), &distances, &carbon_costs };
+    SolverOptions solver_options;
+    solver_options.time_limit = time_limit;
+    solver_options.coefficient = coefficient;
+    solver_options.rounding_time_share = rounding_time_share;
+    solver_options.use_log = use_log;
+    solver_options.use_worker = use_worker;
+    solver_options.output = num_models == 1 && concurrent_runs == 1;
+    solver_options.bpp_exact_limit = bpp_exact_limit;
+    solver_options.granularity = granularity;
+    solver_options.rounding_frequency = rounding_frequency;
+    solver_options.threads = threads_per_model;
+    solver_options.pool_solutions = command_line["pool-solutions"].as<int>();
+
+    // The outputs are opened first, so a bad path fails the run before the license is checked or anything is solved
+    bool resume = command_line["resume"].as<bool>();
+    FrontStream stream;
+    if (command_line.count("stream-output"))
+        stream.open(command_line["stream-output"].as<std::string>(), resume);
+    auto stream_point = [&stream](const ParetoPoint& point) { stream.push(point); };
+
+    FILE *f = csv_filename.empty() ? nullptr : fopen(csv_filename.c_str(), resume ? "a" : "w");
+    if (!csv_filename.empty() && f == nullptr)
+        throw std::runtime_error("couldn't open file " + csv_filename);
+
+    CutPool cut_pool;
+    ParetoArchive archive;
+    if (stream.isOpen() && !resume)
+        archive.setListener(stream_point);
+
+    // Gurobi may throw from here on, and a daemon keeps running after that, so the CSV file is closed either way
     try
     {
-        GRBEnv env = GRBEnv(true);
-        env.start();
-
-        GRBModel model = GRBModel(env);
-        model.set(GRB_IntParam_LazyConstraints, 1);
-        model.set(GRB_DoubleParam_TimeLimit, time_limit);
-        model.set(GRB_IntParam_OutputFlag, 1);
-
-        // x_e variables
-        GRBVar **x = new GRBVar*[N];
-        x[0] = nullptr;
-        for (int i = 1; i < N; i++)
+        // Starting a Gurobi environment checks the license, so they are reused by the following runs
+        while ((int) envs.size() < num_models)
         {
-            GRBVar *row = new GRBVar[i];
-            for (int j = 0; j < i; j++)
+            GRBEnv* env = new GRBEnv(true);
+            try
+            {
+                env->set(GRB_IntParam_OutputFlag, 0);
+                env->start();
+            }
+            catch (...)
             {
-                std::string varname = "x[" + std::to_string(i) + "][" + std::to_string(j) + "]";
-                double upper_limit = j == 0 ? 2.0 : 1.0;
-                row[j] = model.addVar(0.0, upper_limit, 0, GRB_INTEGER, varname);
-                if (use_heur)
-                    row[j].set(GRB_DoubleAttr_Start, heur_vals[i][j]);
+                delete env;
+                throw;
             }
-            x[i] = row;
+            envs.push_back(env);
         }
 
-        // Free heuristic values space
-        if (use_heur)
+        SolverPool pool(problem, solver_options, num_models, cut_pool, envs);
+        FrontDriver driver(pool, archive, front_options, f);
+        driver.setHeuristicStarts(heuristic_starts, command_line["heuristic-starts"].as<int>());
+        if (command_line.count("checkpoint"))
+            driver.enableCheckpoints(command_line["checkpoint"].as<std::string>(), cut_pool, problem);
+
+        if (resume && !driver.resume())
         {
-            for (int i = 1; i < N; i++)
-                delete[] heur_vals[i];
-            delete[] heur_vals;
+            std::cout << "Error: couldn't resume from the checkpoint file" << std::endl;
+            summary.status = "resume failed";
         }
-
-        // Degree constraints (clients)
-        for (int i = 1; i < N; i++)
+        else if (!resume && !driver.solveEndpoints(distance_start, carbon_start))
         {
-            GRBLinExpr c = 0.0;
-            for (int j = 0; j < N; j++)
-                if (i != j)
-                    c += x[std::max(i,j)][std::min(i,j)];
-            model.addConstr(c, GRB_EQUAL, 2);
+            std::cout << "Error: no solution found for one of the objectives" << std::endl;
+            summary.status = "no solution";
         }
+        else
+        {
+            // The points restored by resume were streamed by the run that found them
+            if (stream.isOpen() && resume)
+                archive.setListener(stream_point);
+            driver.run();
+        }
+    }
+    catch (...)
+    {
+        if (f)
+            fclose(f);
+        throw;
+    }
 
-        double total_demands = 0.0;
-        for (auto &p : clients)
-            total_demands += p.d;
-
-        V = std::min<int>(V, std::ceil((2*total_demands) / C));
-
-        // Degree constraints (warehouse)
-        GRBLinExpr c = 0.0;
-        for (int i = 1; i < N; i++)
-            c += x[i][0];
-        model.addConstr(c, GRB_LESS_EQUAL, 2 * V);
-
-        double* demands = new double[N];
-        for (int i = 0; i < N; i++)
-            demands[i] = clients[i].d;
-
-        
-        model.update();
-        int num_spanning_cover = 0;
-        subtourelim cb(x, demands, N, V, C, coefficient, use_log, &num_spanning_cover);
-        model.setCallback(&cb);
-
-        // Objectives
-
-        GRBLinExpr obj_distance_traveled = 0.0;
-        for (int i = 1; i < N; i++)
-            for (int j = 0; j < i; j++)
-                obj_distance_traveled +=  dist(clients[i], clients[j]) * x[i][j];
-
-        GRBLinExpr obj_carbon_emissions = 0.0;
-        for (int i = 1; i < N; i++)
-            for (int j = 0; j < i; j++)
-                obj_carbon_emissions += carbon_factors[i][j] * dist(clients[i], clients[j]) * x[i][j];
-
-        for (int i = 1; i < N; i++)
-            delete[] carbon_factors[i];
-        delete[] carbon_factors;
-
-        FILE *f = fopen(csv_filename.c_str(), "w");
+    if (f)
+        fclose(f);
 
-        model.setObjective(obj_distance_traveled, GRB_MINIMIZE);
-        model.optimize();
-        double best_obj1 = model.get(GRB_DoubleAttr_ObjVal);
-        double nadir_obj2 = obj_carbon_emissions.getValue();
+    printf("Non-dominated points found: %zu\n", archive.size());
+    printf("Hypervolume (reference at the nadir point): %lf\n", archive.hypervolume());
+    printf("Spacing: %lf\n", archive.spacing());
 
-        fprintf(f, "%lf,%lf\n", obj_distance_traveled.getValue(), obj_carbon_emissions.getValue());
+    if (command_line.count("archive-output"))
+    {
+        FILE *archive_file = fopen(command_line["archive-output"].as<std::string>().c_str(), "w");
+        if (archive_file == nullptr)
+            throw std::runtime_error("couldn't open file " + command_line["archive-output"].as<std::string>());
+        std::vector<ParetoPoint> points = archive.points();
+        std::vector<double> crowding = archive.crowding();
+        for (size_t k = 0; k < points.size(); k++)
+            fprintf(archive_file, "%lf,%lf,%lf\n", points[k].distance, points[k].carbon, crowding[k]);
+        fclose(archive_file);
+    }
 
-        model.setObjective(obj_carbon_emissions, GRB_MINIMIZE);
-        model.optimize();
-        double best_obj2 = model.get(GRB_DoubleAttr_ObjVal);
-        double nadir_obj1 = obj_distance_traveled.getValue();
+    summary.N = N;
+    summary.min_K = min_K;
+    summary.points = archive.size();
+    summary.hypervolume = archive.hypervolume();
+    summary.spacing = archive.spacing();
+    summary.min_distance = summary.min_carbon = std::numeric_limits<double>::infinity();
+    for (const ParetoPoint& point : archive.points())
+    {
+        summary.min_distance = std::min(summary.min_distance, point.distance);
+        summary.min_carbon = std::min(summary.min_carbon, point.carbon);
+    }
+    summary.front = archive.points();
+    summary.crowding = archive.crowding();
+    summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-        fprintf(f, "%lf,%lf\n", obj_distance_traveled.getValue(), obj_carbon_emissions.getValue());
+    return summary;
+}
 
-        printf("Minimum distance traveled: %lf\nMinimum carbon emissions: %lf\n", best_obj1, best_obj2);
+// Each line of the manifest holds the options of one run, as they would be given on the command line
+int runBatch(cxxopts::Options& options, const cxxopts::ParseResult& command_line)
+{
+    std::string manifest_filename = command_line["batch"].as<std::string>();
+    std::ifstream manifest(manifest_filename);
+    if (!manifest.is_open())
+    {
+        std::cout << "Error: couldn't open file " << manifest_filename << std::endl;
+        exit(1);
+    }
 
-        std::queue<weights> Q;
-        Q.push({ 1, 0, 0 });
-        Q.push({ 0, 1, 0 });
+    // Every line is checked before anything is solved
+    std::vector<int> lines;
+    std::vector<std::string> arguments;
+    std::vector<cxxopts::ParseResult*> runs;
+    std::string line;
+    for (int line_number = 1; std::getline(manifest, line); line_number++)
+    {
+        line = line.substr(0, line.find('#'));
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
 
-        printf("\n-------------------\n");
-        while (!Q.empty()) 
+        std::string error;
+        cxxopts::ParseResult* run = parseLine(options, line, error);
+        if (run == nullptr || !run->count("csv-output"))
         {
-            weights p1 = Q.front();
-            Q.pop();
-            weights p2 = Q.front();
-            Q.pop();
+            std::cout << "Error: " << manifest_filename << ", line " << line_number << ": "
+                << (run == nullptr ? error : "the CSV output file is required") << std::endl;
+            exit(1);
+        }
 
-            weights p3 = { (p1.w1 + p2.w1)/2, (p1.w2 + p2.w2)/2, std::max(p1.layer, p2.layer) + 1 };
+        runs.push_back(run);
+        lines.push_back(line_number);
+        arguments.push_back(line.substr(line.find_first_not_of(" \t")));
+        arguments.back().erase(arguments.back().find_last_not_of(" \t\r") + 1);
+    }
 
-            GRBVar makespan;
-            GRBConstr makespan_1, makespan_2;
-            if (use_tcheby)
+    std::string output_filename = command_line["batch-output"].as<std::string>();
+    FILE* output = fopen(output_filename.c_str(), "w");
+    if (!output)
+    {
+        std::cout << "Error: couldn't open file " << output_filename << std::endl;
+        exit(1);
+    }
+    fprintf(output, "line,instance,options,status,vertices,min_vehicles,points,hypervolume,spacing,min_distance,min_carbon,seconds\n");
+    fflush(output);
+
+    int num_workers = std::max(1, std::min<int>(command_line["batch-workers"].as<int>(), runs.size()));
+    std::atomic<size_t> next_run(0);
+    std::atomic<int> finished(0), failed(0);
+    std::mutex output_mutex;
+
+    // Each worker keeps its Gurobi environments from one run to the next
+    auto work = [&]() {
+        std::vector<GRBEnv*> envs;
+        size_t i;
+        while ((i = next_run++) < runs.size())
+        {
+            RunSummary summary = {};
+            try
             {
-                makespan = model.addVar(0.0, std::numeric_limits<double>::infinity(), 0.0, GRB_CONTINUOUS, "D");
-                if (normalize)
-                {
-                    makespan_1 = model.addConstr(p3.w1 * (obj_distance_traveled - best_obj1) / (use_nadir ? (nadir_obj1 - best_obj1) : best_obj1), GRB_LESS_EQUAL, makespan, "makespan_1");
-                    makespan_2 = model.addConstr(p3.w2 * (obj_carbon_emissions - best_obj2) / (use_nadir ? (nadir_obj2 - best_obj2) : best_obj2), GRB_LESS_EQUAL, makespan, "makespan_2");
-                } 
-                else
-                {
-                    makespan_1 = model.addConstr(p3.w1 * (obj_distance_traveled - best_obj1), GRB_LESS_EQUAL, makespan, "makespan_1");
-                    makespan_2 = model.addConstr(p3.w2 * (obj_carbon_emissions - best_obj2), GRB_LESS_EQUAL, makespan, "makespan_2");
-                }
-                GRBLinExpr obj_makespan = 0.0;
-                obj_makespan += makespan;
-                model.setObjective(obj_makespan, GRB_MINIMIZE);
+                summary = solveInstance(*runs[i], envs, num_workers);
             }
-            else
+            catch (GRBException e)
             {
-                if (normalize)
-                    model.setObjective(p3.w1 * (obj_distance_traveled - best_obj1) / (use_nadir ? (nadir_obj1 - best_obj1) : best_obj1) + p3.w2 * (obj_carbon_emissions - best_obj2) / (use_nadir ? (nadir_obj2 - best_obj2) : best_obj2), GRB_MINIMIZE);
-                else
-                    model.setObjective(p3.w1 * (obj_distance_traveled - best_obj1) + p3.w2 * (obj_carbon_emissions - best_obj2), GRB_MINIMIZE);
+                summary.status = "Gurobi error " + std::to_string(e.getErrorCode()) + ": " + e.getMessage();
             }
-
-            model.optimize();
-
-            printf("Weights (%lf, %lf)\n", p3.w1, p3.w2);
-            printf("Distance traveled: %lf\n", obj_distance_traveled.getValue());
-            printf("Carbon emission: %lf\n", obj_carbon_emissions.getValue());
-            printf("-------------------\n");
-
-            fprintf(f, "%lf,%lf\n", obj_distance_traveled.getValue(), obj_carbon_emissions.getValue());
-
-            if (use_tcheby)
+            catch (const std::exception& e)
             {
-                model.remove(makespan_1);
-                model.remove(makespan_2);
-                model.remove(makespan);
+                summary.status = std::string("error: ") + e.what();
             }
 
-            if (p3.layer < MAX_WEIGHTS_LAYERS) 
-            {
-                Q.push(p1);
-                Q.push(p3);
+            std::lock_guard<std::mutex> lock(output_mutex);
+            fprintf(output, "%d,%s,%s,%s,%d,%d,%zu,%lf,%lf,%lf,%lf,%.2lf\n", lines[i], csvField((*runs[i])["file"].as<std::string>()).c_str(),
+                csvField(arguments[i]).c_str(), csvField(summary.status).c_str(), summary.N, summary.min_K, summary.points,
+                summary.hypervolume, summary.spacing, summary.min_distance, summary.min_carbon, summary.seconds);
+            fflush(output);
 
-                Q.push(p2);
-                Q.push(p3);
-            }
+            if (summary.status != "ok")
+                failed++;
+            printf("Batch: %d/%zu runs done (line %d: %s)\n", ++finished, runs.size(), lines[i], summary.status.c_str());
         }
-        fclose(f);
 
-        // Deallocating
-        for (int i = 1; i < N; i++)
-            delete[] x[i];
-        delete[] x;
-        delete[] demands;
-    } 
-    catch (GRBException e) 
-    {
-        std::cout << "Error code = " << e.getErrorCode() << std::endl;
-        std::cout << e.getMessage() << std::endl;
-    } 
-    catch (...) 
-    {
-        std::cout << "Unknown error" << std::endl;
-    }
+        for (GRBEnv* env : envs)
+            delete env;
+    };
 
-    return 0;
-}
+    std::vector<std::thread> workers;
+    for (int k = 1; k < num_workers; k++)
+        workers.emplace_back(work);
+    work();
+    for (auto& t : workers)
+        t.join();
 
-double dist(const Point& a, const Point& b)
-{
-    return std::sqrt( (a.x - b.x)*(a.x - b.x) + (a.y - b.y)*(a.y - b.y) );
+    fclose(output);
+    printf("Batch finished: %zu runs, %d failed, results in %s\n", runs.size(), failed.load(), output_filename.c_str());
+
+    for (cxxopts::ParseResult* run : runs)
+        delete run;
+    return failed > 0 ? 1 : 0;
 }
 
-std::vector<Point> getPointsFromFile(std::string filename, int *V, double *C, double**& carbon_factors)
+// Serves requests until stdin is closed, or from one socket connection after another until killed.
+// The Gurobi environments are started by the first request and kept for all of the following ones.
+int runDaemon(cxxopts::Options& options, const cxxopts::ParseResult& command_line)
 {
-    int N;
-    
-    std::ifstream f(filename);
-    std::string linebuffer;
-    if (!f.is_open()) 
+    std::vector<GRBEnv*> envs;
+
+    if (!command_line.count("socket"))
     {
-        std::cout << "Error: couldn't open file " << filename << std::endl;
-        exit(1);
+        // The responses take stdout, so the solver's log goes to stderr
+        int response_fd = dup(STDOUT_FILENO);
+        dup2(STDERR_FILENO, STDOUT_FILENO);
+        FILE* out = fdopen(response_fd, "w");
+        serveRequests(options, stdin, out, envs);
+        fclose(out);
     }
+    else
+    {
+        std::string path = command_line["socket"].as<std::string>();
+        sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path))
+        {
+            std::cout << "Error: socket path " << path << " is too long" << std::endl;
+            exit(1);
+        }
+        path.copy(address.sun_path, path.size());
 
-    getline(f, linebuffer);
-    sscanf(linebuffer.c_str(), "%i %i %lf\n", &N, V, C);
-
-    carbon_factors = new double*[N];
-    carbon_factors[0] = nullptr;
-    for (int i = 1; i < N; i++)
-        carbon_factors[i] = new double[i];
-
-    std::vector<Point> points;
-    points.reserve(N);
+        // A socket left behind by a daemon that was killed is replaced
+        struct stat info;
+        if (stat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode))
+            unlink(path.c_str());
 
-    for (int i = 0; i < N; i++)
-    {
-        getline(f, linebuffer);
-        if (!linebuffer.empty()) 
+        int server = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (server < 0 || bind(server, (sockaddr*) &address, sizeof(address)) < 0 || listen(server, 16) < 0)
         {
-            Point p;
-            sscanf(linebuffer.c_str(), "%lf %lf %lf", &p.d, &p.x, &p.y);
-            points.push_back(p);
+            std::cout << "Error: couldn't listen on " << path << ": " << strerror(errno) << std::endl;
+            exit(1);
         }
-    }
 
-    getline(f, linebuffer);
+        // A client that leaves before its response only ends its own connection
+        signal(SIGPIPE, SIG_IGN);
+        printf("Waiting for requests on %s\n", path.c_str());
+        fflush(stdout);
 
-    double factor;
-    for (int i = 1; i < N; i++)
-        for (int j = 0; j < i; j++) {
-            f >> factor;
-            carbon_factors[i][j] = factor;
+        while (true)
+        {
+            int client = accept(server, nullptr, nullptr);
+            if (client < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                std::cout << "Error: " << strerror(errno) << std::endl;
+                break;
+            }
+
+            FILE* in = fdopen(client, "r");
+            FILE* out = fdopen(dup(client), "w");
+            serveRequests(options, in, out, envs);
+            fclose(in);
+            fclose(out);
         }
+        close(server);
+    }
 
-    f.close();
-    return points;
+    for (GRBEnv* env : envs)
+        delete env;
+    return 0;
 }
 
-double** getHeuristicSol(std::string filename, int N, int V, double* upper_bound)
+// A request is a line of options, the response a status line followed by the non-dominated points, one per line
+// with the CSV columns of --archive-output and the routes (clients separated by spaces, routes by semicolons),
+// and a line with a single dot:
+//     ok <points> <hypervolume> <spacing> <seconds>      or      error <message>
+void serveRequests(cxxopts::Options& options, FILE* in, FILE* out, std::vector<GRBEnv*>& envs)
 {
-    std::ifstream f(filename + ".heu");
-    if (!f.is_open())
-    {
-        std::cout << "Error: couldn't open file " << filename << std::endl;
-        exit(1);
-    }
-
-    double** vals = new double*[N];
-    vals[0] = nullptr;
-    for (int i = 1; i < N; i++)
+    char* buffer = nullptr;
+    size_t capacity = 0;
+    while (getline(&buffer, &capacity, in) != -1)
     {
-        vals[i] = new double[i];
-        for (int j = 0; j < i; j++)
-            vals[i][j] = 0.0;
-    }
+        std::string line(buffer);
+        if (line.find_first_not_of(" \t\r\n") == std::string::npos)
+            continue;
+
+        std::string error;
+        cxxopts::ParseResult* run = parseLine(options, line, error);
+        RunSummary summary = {};
+        if (run != nullptr)
+        {
+            try
+            {
+                summary = solveInstance(*run, envs, 1);
+                if (summary.status != "ok")
+                    error = summary.status;
+            }
+            catch (GRBException e)
+            {
+                error = "Gurobi error " + std::to_string(e.getErrorCode()) + ": " + e.getMessage();
+            }
+            catch (const std::exception& e)
+            {
+                error = e.what();
+            }
+            delete run;
+        }
+        fflush(stdout);
 
-    f >> (*upper_bound);
-    for (int k = 0; k < V; k++)
-    {
-        int last_vertex, current_vertex;
-        f >> last_vertex;
-        f >> current_vertex;
-        while (current_vertex != 0)
+        if (!error.empty())
+            fprintf(out, "error %s\n", error.c_str());
+        else
         {
-            vals[std::max(last_vertex, current_vertex)][std::min(last_vertex, current_vertex)] += 1.0;
-            last_vertex = current_vertex;
-            f >> current_vertex;
+            fprintf(out, "ok %zu %lf %lf %.3lf\n", summary.points, summary.hypervolume, summary.spacing, summary.seconds);
+            for (size_t k = 0; k < summary.front.size(); k++)
+            {
+                fprintf(out, "%lf,%lf,%lf,", summary.front[k].distance, summary.front[k].carbon, summary.crowding[k]);
+                const Routes& routes = summary.front[k].routes;
+                for (size_t r = 0; r < routes.size(); r++)
+                    for (size_t c = 0; c < routes[r].size(); c++)
+                        fprintf(out, "%d%s", routes[r][c], c + 1 < routes[r].size() ? " " : (r + 1 < routes.size() ? ";" : ""));
+                fprintf(out, "\n");
+            }
         }
+        fprintf(out, ".\n");
+        fflush(out);
+    }
+    free(buffer);
+}
+
+std::string csvField(const std::string& text)
+{
+    if (text.find_first_of(",\"\n") == std::string::npos)
+        return text;
 
-        if (last_vertex != current_vertex)
-            vals[std::max(last_vertex, current_vertex)][std::min(last_vertex, current_vertex)] += 1.0;
+    std::string quoted = "\"";
+    for (char c : text)
+    {
+        if (c == '"')
+            quoted += '"';
+        quoted += c;
     }
+    return quoted + "\"";
+}
 
-    f.close();
-    return vals;
+double dist(const Point& a, const Point& b)
+{
+    return std::sqrt( (a.x - b.x)*(a.x - b.x) + (a.y - b.y)*(a.y - b.y) );
 }
 
-void writeSolution(GRBVar** x, int N, int V, const double obj, const int opt, const std::string& filename)
+// Every solution of <file>.heu. Each one starts with a header, the upper bound of the original format or the
+// solution's distance and carbon emissions, followed by its routes written as 0 c1 c2 ... 0
+std::vector<HeuristicSolution> getHeuristicSols(std::string filename)
 {
-    std::ofstream f(filename + ".sol");
-    if (!f.is_open()) 
+    std::vector<HeuristicSolution> solutions;
+    std::ifstream f(filename + ".heu");
+    if (!f.is_open())
     {
-        std::cout << "Error: couldn't open file " << filename + ".sol" << std::endl;
-        exit(1);
+        std::cout << "Couldn't open " << filename << ".heu, using the savings heuristic instead" << std::endl;
+        return solutions;
     }
 
-    f << std::fixed << std::setprecision(2) << obj << ' ' << opt << '\n';
-    std::vector<bool> seen;
-    for (int i = 0; i < N; i++)
-        seen.push_back(false);
-
-    for (int k = 0; k < V; k++)
+    std::vector<int> route;
+    bool in_route = false;
+    double value;
+    while (f >> value)
     {
-        std::list<int> tour;
-        tour.push_back(0);
-        int next;
-        int current = 0;
-        do {
-            next = 0;
-            for (int j = 1; j < N; j++)
+        if (in_route)
+        {
+            if (value != 0)
+                route.push_back((int) value);
+            else
             {
-                if (current != j && !seen[j] && x[std::max(current, j)][std::min(current, j)].get(GRB_DoubleAttr_X) > 0.5)
-                {
-                    next = j;
-                    tour.push_back(j);
-                    current = j;
-                    seen[j] = true;
-                    break;
-                }
+                if (!route.empty())
+                    solutions.back().routes.push_back(route);
+                route.clear();
+                in_route = false;
             }
-        } while (next != 0);
-        tour.push_back(0);
-
-        if (tour.size() > 2)
-        for (auto it = tour.begin(); it != tour.end(); ++it)
+        }
+        else if (value == 0)
         {
-            f << *it;
-            if (std::next(it) == tour.end())
-                f << '\n';
-            else
-                f << ' ';
+            if (solutions.empty())
+                solutions.push_back({});
+            in_route = true;
+        }
+        else
+        {
+            // A number after some routes, or after a complete header, starts the next solution
+            if (solutions.empty() || !solutions.back().routes.empty() || solutions.back().header.size() == 2)
+                solutions.push_back({});
+            solutions.back().header.push_back(value);
         }
     }
+    if (!route.empty())
+        solutions.back().routes.push_back(route);
 
     f.close();
+    return solutions;
 }
\ No newline at end of file